@@ -0,0 +1,517 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup IO
+  \brief Implementation of classes stir::ChunkedDataFile and stir::ChunkedDataFileWriter
+*/
+
+#include "stir/IO/ChunkedDataFile.h"
+#include "stir/ByteOrder.h"
+#include "stir/error.h"
+#include "stir/warning.h"
+#include "stir/format.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <streambuf>
+#ifdef HAVE_ZLIB
+#  include <zlib.h>
+#endif
+
+START_NAMESPACE_STIR
+
+// Note: the signature is exactly 16 bytes (without the trailing 0)
+static const char chunked_data_file_signature[] = "STIR chunked v1\n";
+static const std::size_t signature_length = 16;
+
+static const std::uint32_t flag_compressed = 1;
+
+// helpers for reading/writing the header (in little endian)
+
+template <typename T>
+static void
+write_number(std::ostream& s, T value)
+{
+  ByteOrder(ByteOrder::little_endian).swap_if_necessary(value);
+  s.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static T
+read_number(std::istream& s)
+{
+  T value;
+  s.read(reinterpret_cast<char*>(&value), sizeof(T));
+  ByteOrder(ByteOrder::little_endian).swap_if_necessary(value);
+  return value;
+}
+
+// compression of a single chunk
+
+static void
+encode_chunk(std::vector<char>& stored,
+             bool& compressed,
+             float& scale,
+             const std::vector<float>& data,
+             const int compression_level,
+             const bool quantise_to_16_bits)
+{
+  const std::size_t num_elements = data.size();
+  const int num_bytes_per_element = quantise_to_16_bits ? 2 : 4;
+  const char* raw_ptr;
+  std::vector<std::int16_t> quantised_data;
+  if (quantise_to_16_bits)
+    {
+      float max_abs = 0.F;
+      for (const float value : data)
+        max_abs = std::max(max_abs, std::fabs(value));
+      scale = max_abs > 0 ? max_abs / 32767.F : 1.F;
+      quantised_data.resize(num_elements);
+      for (std::size_t i = 0; i < num_elements; ++i)
+        quantised_data[i] = static_cast<std::int16_t>(std::lround(data[i] / scale));
+      raw_ptr = reinterpret_cast<const char*>(quantised_data.data());
+    }
+  else
+    {
+      scale = 1.F;
+      raw_ptr = reinterpret_cast<const char*>(data.data());
+    }
+
+  // shuffle bytes
+  std::vector<char> shuffled(num_elements * num_bytes_per_element);
+  for (int b = 0; b < num_bytes_per_element; ++b)
+    for (std::size_t i = 0; i < num_elements; ++i)
+      shuffled[b * num_elements + i] = raw_ptr[i * num_bytes_per_element + b];
+
+  compressed = false;
+#ifdef HAVE_ZLIB
+  if (compression_level > 0 && !shuffled.empty())
+    {
+      uLongf stored_size = compressBound(static_cast<uLong>(shuffled.size()));
+      stored.resize(stored_size);
+      if (compress2(reinterpret_cast<Bytef*>(stored.data()),
+                    &stored_size,
+                    reinterpret_cast<const Bytef*>(shuffled.data()),
+                    static_cast<uLong>(shuffled.size()),
+                    compression_level)
+              == Z_OK
+          && stored_size < shuffled.size())
+        {
+          stored.resize(stored_size);
+          compressed = true;
+          return;
+        }
+    }
+#endif
+  stored.swap(shuffled);
+}
+
+static Succeeded
+decode_chunk(char* output,
+             const std::vector<char>& stored,
+             const bool compressed,
+             const float scale,
+             const std::size_t num_elements,
+             const int num_bytes_per_element)
+{
+  const std::size_t num_bytes = num_elements * num_bytes_per_element;
+  std::vector<char> shuffled;
+  const char* shuffled_ptr = stored.data();
+  if (compressed)
+    {
+#ifdef HAVE_ZLIB
+      shuffled.resize(num_bytes);
+      uLongf size = static_cast<uLongf>(num_bytes);
+      if (uncompress(reinterpret_cast<Bytef*>(shuffled.data()),
+                     &size,
+                     reinterpret_cast<const Bytef*>(stored.data()),
+                     static_cast<uLong>(stored.size()))
+              != Z_OK
+          || size != num_bytes)
+        return Succeeded::no;
+      shuffled_ptr = shuffled.data();
+#else
+      warning("ChunkedDataFile: file is compressed, but STIR was built without zlib");
+      return Succeeded::no;
+#endif
+    }
+  else if (stored.size() != num_bytes)
+    return Succeeded::no;
+
+  if (num_bytes_per_element == 4)
+    {
+      for (int b = 0; b < 4; ++b)
+        for (std::size_t i = 0; i < num_elements; ++i)
+          output[i * 4 + b] = shuffled_ptr[b * num_elements + i];
+    }
+  else
+    {
+      std::int16_t value;
+      char* value_ptr = reinterpret_cast<char*>(&value);
+      for (std::size_t i = 0; i < num_elements; ++i)
+        {
+          value_ptr[0] = shuffled_ptr[i];
+          value_ptr[1] = shuffled_ptr[num_elements + i];
+          const float float_value = value * scale;
+          std::memcpy(output + i * 4, &float_value, 4);
+        }
+    }
+  return Succeeded::yes;
+}
+
+/***************************** ChunkedDataFile *****************************/
+
+namespace detail
+{
+//! stream buffer that reads from a ChunkedDataFile
+/*! Keeps one decompressed chunk. Large reads go directly to ChunkedDataFile::read().
+    The position is always equal to buffer_start + (gptr() - eback()).
+*/
+class ChunkedDataStreamBuffer : public std::streambuf
+{
+public:
+  explicit ChunkedDataStreamBuffer(const shared_ptr<const ChunkedDataFile>& file_sptr)
+      : file_sptr(file_sptr),
+        buffer_start(0)
+  {}
+
+protected:
+  int_type underflow() override
+  {
+    const std::streamoff pos = this->get_position();
+    if (pos >= this->file_sptr->get_uncompressed_size())
+      return traits_type::eof();
+    const std::size_t chunk_num = this->file_sptr->find_chunk(pos);
+    if (this->file_sptr->read_chunk(this->buffer, chunk_num) == Succeeded::no)
+      {
+        this->set_position(pos);
+        return traits_type::eof();
+      }
+    this->buffer_start = this->file_sptr->get_chunk_start(chunk_num);
+    char* const start = this->buffer.data();
+    this->setg(start, start + (pos - this->buffer_start), start + this->buffer.size());
+    return traits_type::to_int_type(*this->gptr());
+  }
+
+  std::streamsize xsgetn(char* s, std::streamsize n) override
+  {
+    const std::streamoff pos = this->get_position();
+    if (pos >= this->file_sptr->get_uncompressed_size())
+      return 0;
+    // large read: decompress all chunks at once (and in parallel)
+    const std::size_t chunk_num = this->file_sptr->find_chunk(pos);
+    const std::streamoff chunk_end = chunk_num + 1 < this->file_sptr->get_num_chunks()
+                                         ? this->file_sptr->get_chunk_start(chunk_num + 1)
+                                         : this->file_sptr->get_uncompressed_size();
+    if (pos + n <= chunk_end || this->egptr() - this->gptr() >= n)
+      return std::streambuf::xsgetn(s, n);
+
+    n = std::min(n, static_cast<std::streamsize>(this->file_sptr->get_uncompressed_size() - pos));
+    if (this->file_sptr->read(s, pos, n) == Succeeded::no)
+      return 0;
+    this->set_position(pos + n);
+    return n;
+  }
+
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+  {
+    if (!(which & std::ios_base::in))
+      return pos_type(off_type(-1));
+    std::streamoff new_pos;
+    if (dir == std::ios_base::beg)
+      new_pos = off;
+    else if (dir == std::ios_base::cur)
+      new_pos = this->get_position() + off;
+    else
+      new_pos = this->file_sptr->get_uncompressed_size() + off;
+    if (new_pos < 0 || new_pos > this->file_sptr->get_uncompressed_size())
+      return pos_type(off_type(-1));
+    this->set_position(new_pos);
+    return pos_type(new_pos);
+  }
+
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+  {
+    return this->seekoff(off_type(pos), std::ios_base::beg, which);
+  }
+
+private:
+  shared_ptr<const ChunkedDataFile> file_sptr;
+  std::vector<char> buffer;
+  std::streamoff buffer_start;
+
+  std::streamoff get_position() const { return this->buffer_start + (this->gptr() - this->eback()); }
+
+  void set_position(const std::streamoff pos)
+  {
+    if (!this->buffer.empty() && pos >= this->buffer_start
+        && pos < this->buffer_start + static_cast<std::streamoff>(this->buffer.size()))
+      {
+        this->setg(this->eback(), this->eback() + (pos - this->buffer_start), this->egptr());
+      }
+    else
+      {
+        this->buffer.clear();
+        this->buffer_start = pos;
+        this->setg(nullptr, nullptr, nullptr);
+      }
+  }
+};
+
+//! holds the stream buffer (needs to be constructed before the std::iostream)
+struct ChunkedDataStreamBufferHolder
+{
+  explicit ChunkedDataStreamBufferHolder(const shared_ptr<const ChunkedDataFile>& file_sptr)
+      : stream_buffer(file_sptr)
+  {}
+  ChunkedDataStreamBuffer stream_buffer;
+};
+
+class ChunkedDataStream : private ChunkedDataStreamBufferHolder, public std::iostream
+{
+public:
+  explicit ChunkedDataStream(const shared_ptr<const ChunkedDataFile>& file_sptr)
+      : ChunkedDataStreamBufferHolder(file_sptr),
+        std::iostream(&stream_buffer)
+  {}
+};
+} // namespace detail
+
+bool
+ChunkedDataFile::has_signature(const std::string& filename)
+{
+  std::ifstream s(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!s)
+    return false;
+  char signature[signature_length];
+  s.read(signature, signature_length);
+  return s && std::strncmp(signature, chunked_data_file_signature, signature_length) == 0;
+}
+
+shared_ptr<std::iostream>
+ChunkedDataFile::create_stream(const shared_ptr<const ChunkedDataFile>& file_sptr)
+{
+  return shared_ptr<std::iostream>(new detail::ChunkedDataStream(file_sptr));
+}
+
+ChunkedDataFile::ChunkedDataFile(const std::string& filename)
+    : filename(filename)
+{
+  this->file.open(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!this->file)
+    error(format("ChunkedDataFile: error opening file {}", filename));
+
+  char signature[signature_length];
+  this->file.read(signature, signature_length);
+  if (!this->file || std::strncmp(signature, chunked_data_file_signature, signature_length) != 0)
+    error(format("ChunkedDataFile: file {} is not a chunked data file", filename));
+
+  this->num_bytes_per_element = static_cast<int>(read_number<std::uint32_t>(this->file));
+  read_number<std::uint32_t>(this->file); // reserved
+  const std::uint64_t num_chunks = read_number<std::uint64_t>(this->file);
+  const std::uint64_t table_offset = read_number<std::uint64_t>(this->file);
+  if (!this->file || (this->num_bytes_per_element != 2 && this->num_bytes_per_element != 4) || table_offset == 0)
+    error(format("ChunkedDataFile: file {} has an invalid header (was it completely written?)", filename));
+
+  this->file.seekg(static_cast<std::streamoff>(table_offset));
+  this->chunks.resize(static_cast<std::size_t>(num_chunks));
+  std::streamoff uncompressed_offset = 0;
+  for (auto& chunk : this->chunks)
+    {
+      chunk.uncompressed_offset = uncompressed_offset;
+      chunk.stored_offset = static_cast<std::streamoff>(read_number<std::uint64_t>(this->file));
+      chunk.stored_size = static_cast<std::streamoff>(read_number<std::uint64_t>(this->file));
+      chunk.num_elements = static_cast<std::size_t>(read_number<std::uint64_t>(this->file));
+      chunk.scale = read_number<float>(this->file);
+      chunk.compressed = (read_number<std::uint32_t>(this->file) & flag_compressed) != 0;
+      uncompressed_offset += static_cast<std::streamoff>(chunk.num_elements * sizeof(float));
+    }
+  if (!this->file)
+    error(format("ChunkedDataFile: error reading table of chunks from file {}", filename));
+  this->uncompressed_size = uncompressed_offset;
+}
+
+std::streamoff
+ChunkedDataFile::get_uncompressed_size() const
+{
+  return this->uncompressed_size;
+}
+
+std::size_t
+ChunkedDataFile::get_num_chunks() const
+{
+  return this->chunks.size();
+}
+
+std::size_t
+ChunkedDataFile::find_chunk(const std::streamoff offset) const
+{
+  if (offset < 0 || offset >= this->uncompressed_size)
+    error(format("ChunkedDataFile: offset {} out of range for file {}", offset, this->filename));
+  const auto iter = std::upper_bound(this->chunks.begin(), this->chunks.end(), offset, [](std::streamoff o, const ChunkInfo& c) {
+    return o < c.uncompressed_offset;
+  });
+  return static_cast<std::size_t>(iter - this->chunks.begin()) - 1;
+}
+
+std::streamoff
+ChunkedDataFile::get_chunk_start(const std::size_t chunk_num) const
+{
+  return this->chunks.at(chunk_num).uncompressed_offset;
+}
+
+Succeeded
+ChunkedDataFile::read_chunk(std::vector<char>& buffer, const std::size_t chunk_num) const
+{
+  const ChunkInfo& chunk = this->chunks.at(chunk_num);
+  std::vector<char> stored(static_cast<std::size_t>(chunk.stored_size));
+  bool read_ok;
+#ifdef STIR_OPENMP
+#  pragma omp critical(CHUNKEDDATAFILEREAD)
+#endif
+  {
+    this->file.clear();
+    this->file.seekg(chunk.stored_offset);
+    this->file.read(stored.data(), chunk.stored_size);
+    read_ok = !this->file.fail();
+  }
+  if (!read_ok)
+    return Succeeded::no;
+  buffer.resize(chunk.num_elements * sizeof(float));
+  return decode_chunk(buffer.data(), stored, chunk.compressed, chunk.scale, chunk.num_elements, this->num_bytes_per_element);
+}
+
+Succeeded
+ChunkedDataFile::read(char* buffer, const std::streamoff offset, const std::streamoff length) const
+{
+  if (length <= 0)
+    return Succeeded::yes;
+  if (offset + length > this->uncompressed_size)
+    return Succeeded::no;
+  const int first_chunk_num = static_cast<int>(this->find_chunk(offset));
+  const int last_chunk_num = static_cast<int>(this->find_chunk(offset + length - 1));
+  bool all_ok = true;
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+  for (int chunk_num = first_chunk_num; chunk_num <= last_chunk_num; ++chunk_num)
+    {
+      std::vector<char> chunk_buffer;
+      if (this->read_chunk(chunk_buffer, static_cast<std::size_t>(chunk_num)) == Succeeded::no)
+        {
+#ifdef STIR_OPENMP
+#  pragma omp atomic write
+#endif
+          all_ok = false;
+          continue;
+        }
+      const std::streamoff chunk_start = this->chunks[chunk_num].uncompressed_offset;
+      const std::streamoff copy_start = std::max(offset, chunk_start);
+      const std::streamoff copy_end
+          = std::min(offset + length, chunk_start + static_cast<std::streamoff>(chunk_buffer.size()));
+      std::copy(chunk_buffer.begin() + (copy_start - chunk_start),
+                chunk_buffer.begin() + (copy_end - chunk_start),
+                buffer + (copy_start - offset));
+    }
+  return all_ok ? Succeeded::yes : Succeeded::no;
+}
+
+/***************************** ChunkedDataFileWriter *****************************/
+
+ChunkedDataFileWriter::ChunkedDataFileWriter(const std::string& filename,
+                                             const int compression_level,
+                                             const bool quantise_to_16_bits)
+    : filename(filename),
+      compression_level(compression_level),
+      quantise_to_16_bits(quantise_to_16_bits),
+      is_open(false)
+{
+  if (compression_level < 0 || compression_level > 9)
+    error(format("ChunkedDataFileWriter: compression level should be between 0 and 9, but is {}", compression_level));
+#ifndef HAVE_ZLIB
+  if (compression_level > 0)
+    warning("ChunkedDataFileWriter: STIR was built without zlib. Data will not be compressed.");
+#endif
+  this->file.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!this->file)
+    error(format("ChunkedDataFileWriter: error opening file {}", filename));
+  this->file.write(chunked_data_file_signature, signature_length);
+  write_number<std::uint32_t>(this->file, quantise_to_16_bits ? 2 : 4);
+  write_number<std::uint32_t>(this->file, 0);
+  // number of chunks and table offset, filled in by close()
+  write_number<std::uint64_t>(this->file, 0);
+  write_number<std::uint64_t>(this->file, 0);
+  if (!this->file)
+    error(format("ChunkedDataFileWriter: error writing to file {}", filename));
+  this->is_open = true;
+}
+
+ChunkedDataFileWriter::~ChunkedDataFileWriter()
+{
+  if (this->is_open)
+    if (this->close() == Succeeded::no)
+      warning(format("ChunkedDataFileWriter: error closing file {}", this->filename));
+}
+
+Succeeded
+ChunkedDataFileWriter::write_chunks(const std::vector<std::vector<float>>& data)
+{
+  if (!this->is_open)
+    return Succeeded::no;
+  const int num_new_chunks = static_cast<int>(data.size());
+  std::vector<std::vector<char>> stored(num_new_chunks);
+  std::vector<ChunkInfo> new_chunks(num_new_chunks);
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+  for (int i = 0; i < num_new_chunks; ++i)
+    {
+      encode_chunk(stored[i],
+                   new_chunks[i].compressed,
+                   new_chunks[i].scale,
+                   data[i],
+                   this->compression_level,
+                   this->quantise_to_16_bits);
+      new_chunks[i].num_elements = data[i].size();
+      new_chunks[i].stored_size = static_cast<std::streamoff>(stored[i].size());
+    }
+  for (int i = 0; i < num_new_chunks; ++i)
+    {
+      new_chunks[i].stored_offset = this->file.tellp();
+      this->file.write(stored[i].data(), new_chunks[i].stored_size);
+      this->chunks.push_back(new_chunks[i]);
+    }
+  return this->file ? Succeeded::yes : Succeeded::no;
+}
+
+Succeeded
+ChunkedDataFileWriter::close()
+{
+  if (!this->is_open)
+    return Succeeded::no;
+  this->is_open = false;
+  const std::streamoff table_offset = this->file.tellp();
+  for (const auto& chunk : this->chunks)
+    {
+      write_number<std::uint64_t>(this->file, static_cast<std::uint64_t>(chunk.stored_offset));
+      write_number<std::uint64_t>(this->file, static_cast<std::uint64_t>(chunk.stored_size));
+      write_number<std::uint64_t>(this->file, static_cast<std::uint64_t>(chunk.num_elements));
+      write_number<float>(this->file, chunk.scale);
+      write_number<std::uint32_t>(this->file, chunk.compressed ? flag_compressed : 0);
+    }
+  this->file.seekp(static_cast<std::streamoff>(signature_length + 2 * sizeof(std::uint32_t)));
+  write_number<std::uint64_t>(this->file, static_cast<std::uint64_t>(this->chunks.size()));
+  write_number<std::uint64_t>(this->file, static_cast<std::uint64_t>(table_offset));
+  this->file.close();
+  return this->file ? Succeeded::yes : Succeeded::no;
+}
+
+END_NAMESPACE_STIR
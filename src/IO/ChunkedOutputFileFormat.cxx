@@ -0,0 +1,130 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup IO
+  \brief Implementation of class stir::ChunkedOutputFileFormat
+*/
+
+#include "stir/IO/ChunkedOutputFileFormat.h"
+#include "stir/IO/ChunkedDataFile.h"
+#include "stir/IO/interfile.h"
+#include "stir/VoxelsOnCartesianGrid.h"
+#include "stir/utilities.h"
+#include "stir/warning.h"
+
+START_NAMESPACE_STIR
+
+const char* const ChunkedOutputFileFormat::registered_name = "Chunked";
+
+ChunkedOutputFileFormat::ChunkedOutputFileFormat(const int compression_level, const bool quantise_to_16_bits)
+{
+  base_type::set_defaults();
+  this->compression_level = compression_level;
+  this->quantise_to_16_bits = quantise_to_16_bits;
+}
+
+void
+ChunkedOutputFileFormat::set_defaults()
+{
+  base_type::set_defaults();
+  this->compression_level = 1;
+  this->quantise_to_16_bits = false;
+}
+
+void
+ChunkedOutputFileFormat::initialise_keymap()
+{
+  parser.add_start_key("Chunked Output File Format Parameters");
+  parser.add_stop_key("End Chunked Output File Format Parameters");
+  parser.add_key("compression level", &this->compression_level);
+  parser.add_key("quantise to 16 bits", &this->quantise_to_16_bits);
+  base_type::initialise_keymap();
+}
+
+bool
+ChunkedOutputFileFormat::post_processing()
+{
+  if (base_type::post_processing())
+    return true;
+  if (this->compression_level < 0 || this->compression_level > 9)
+    {
+      warning("ChunkedOutputFileFormat: compression level has to be between 0 and 9");
+      return true;
+    }
+  set_type_of_numbers(this->type_of_numbers, true);
+  set_byte_order(this->file_byte_order, true);
+  return false;
+}
+
+NumericType
+ChunkedOutputFileFormat::set_type_of_numbers(const NumericType& new_type, const bool warn)
+{
+  if (warn && new_type != NumericType::FLOAT)
+    warning("ChunkedOutputFileFormat: can only write floats (use 'quantise to 16 bits' for smaller files). Using float.");
+  this->type_of_numbers = NumericType::FLOAT;
+  return this->type_of_numbers;
+}
+
+ByteOrder
+ChunkedOutputFileFormat::set_byte_order(const ByteOrder& new_byte_order, const bool warn)
+{
+  if (warn && !new_byte_order.is_native_order())
+    warning("ChunkedOutputFileFormat: can only write data in native byte order. Using native.");
+  this->file_byte_order = ByteOrder::native;
+  return this->file_byte_order;
+}
+
+Succeeded
+ChunkedOutputFileFormat::actual_write_to_file(std::string& filename, const DiscretisedDensity<3, float>& density) const
+{
+  // dynamic_cast will throw an exception when it's not valid
+  const VoxelsOnCartesianGrid<float>& image = dynamic_cast<const VoxelsOnCartesianGrid<float>&>(density);
+
+  std::string data_name = filename;
+  {
+    std::string::size_type pos = find_pos_of_extension(filename);
+    if (pos != std::string::npos && filename.substr(pos) == ".hv")
+      replace_extension(data_name, ".chk");
+    else
+      add_extension(data_name, ".chk");
+  }
+  std::string header_name = data_name;
+  replace_extension(header_name, ".hv");
+
+  {
+    ChunkedDataFileWriter writer(data_name, this->compression_level, this->quantise_to_16_bits);
+    // one chunk per plane
+    std::vector<std::vector<float>> chunks(image.get_length());
+    for (int z = image.get_min_index(); z <= image.get_max_index(); ++z)
+      chunks[z - image.get_min_index()].assign(image[z].begin_all_const(), image[z].end_all_const());
+    if (writer.write_chunks(chunks) == Succeeded::no || writer.close() == Succeeded::no)
+      return Succeeded::no;
+  }
+
+  VectorWithOffset<float> scaling_factors(1);
+  scaling_factors.fill(1.F);
+  VectorWithOffset<unsigned long> file_offsets(1);
+  file_offsets.fill(0);
+  const Succeeded success = write_basic_interfile_image_header(header_name,
+                                                               data_name,
+                                                               image.get_exam_info(),
+                                                               image.get_index_range(),
+                                                               image.get_grid_spacing(),
+                                                               image.get_origin(),
+                                                               NumericType::FLOAT,
+                                                               ByteOrder::native,
+                                                               scaling_factors,
+                                                               file_offsets);
+  if (success == Succeeded::yes)
+    filename = header_name;
+  return success;
+}
+
+END_NAMESPACE_STIR
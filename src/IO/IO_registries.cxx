@@ -27,6 +27,7 @@
 #ifndef MINI_STIR
 #  include "stir/modelling/ParametricDiscretisedDensity.h"
 #  include "stir/IO/ITKOutputFileFormat.h"
+#  include "stir/IO/ChunkedOutputFileFormat.h"
 #  include "stir/IO/InterfileDynamicDiscretisedDensityOutputFileFormat.h"
 #  include "stir/IO/InterfileDynamicDiscretisedDensityInputFileFormat.h"
 #  include "stir/IO/InterfileParametricDiscretisedDensityInputFileFormat.h"
@@ -87,6 +88,7 @@ static RegisterInputFileFormat<InterfileImageInputFileFormat> idummy0(0);
 #  ifdef HAVE_ITK
 static ITKOutputFileFormat::RegisterIt dummyITK1;
 #  endif
+static ChunkedOutputFileFormat::RegisterIt dummyChunked1;
 static InterfileDynamicDiscretisedDensityOutputFileFormat::RegisterIt dummydynIntfOut;
 static InterfileParametricDiscretisedDensityOutputFileFormat<ParametricVoxelsOnCartesianGridBaseType>::RegisterIt dummyparIntfOut;
 static MultiDynamicDiscretisedDensityOutputFileFormat::RegisterIt dummydynMultiOut;
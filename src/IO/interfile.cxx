@@ -35,6 +35,9 @@
 #include "stir/CartesianCoordinate3D.h"
 #include "stir/VoxelsOnCartesianGrid.h"
 #include "stir/ProjDataFromStream.h"
+#include "stir/ProjDataFromMappedFile.h"
+#include "stir/ProjDataFromChunkedFile.h"
+#include "stir/IO/ChunkedDataFile.h"
 #include "stir/ProjDataInfoCylindricalArcCorr.h"
 #include "stir/Scanner.h"
 #include "stir/Succeeded.h"
@@ -122,6 +125,20 @@ create_image_and_header_from(InterfileImageHeader& hdr,
   return new VoxelsOnCartesianGrid<float>(hdr.get_exam_info_sptr(), IndexRange<3>(min_indices, max_indices), origin, voxel_size);
 }
 
+//! Open the data file, which can be a raw file or a ChunkedDataFile
+static shared_ptr<istream>
+open_image_data_file(const string& full_data_file_name)
+{
+  if (ChunkedDataFile::has_signature(full_data_file_name))
+    {
+      shared_ptr<const ChunkedDataFile> file_sptr(new ChunkedDataFile(full_data_file_name));
+      return ChunkedDataFile::create_stream(file_sptr);
+    }
+  shared_ptr<ifstream> data_in_sptr(new ifstream);
+  open_read_binary(*data_in_sptr, full_data_file_name);
+  return data_in_sptr;
+}
+
 VoxelsOnCartesianGrid<float>*
 read_interfile_image(istream& input, const string& directory_for_data)
 {
@@ -129,8 +146,8 @@ read_interfile_image(istream& input, const string& directory_for_data)
   char full_data_file_name[max_filename_length];
   VoxelsOnCartesianGrid<float>* image_ptr = create_image_and_header_from(hdr, full_data_file_name, input, directory_for_data);
 
-  ifstream data_in;
-  open_read_binary(data_in, full_data_file_name);
+  shared_ptr<istream> data_in_sptr = open_image_data_file(full_data_file_name);
+  istream& data_in = *data_in_sptr;
 
   data_in.seekg(hdr.data_offset_each_dataset[0]);
 
@@ -180,8 +197,8 @@ read_interfile_dynamic_image(istream& input, const string& directory_for_data)
   DynamicDiscretisedDensity* dynamic_dens_ptr = new DynamicDiscretisedDensity(
       hdr.get_exam_info().time_frame_definitions, hdr.get_exam_info().start_time_in_secs_since_1970, scanner_sptr, image_sptr);
 
-  ifstream data_in;
-  open_read_binary(data_in, full_data_file_name);
+  shared_ptr<istream> data_in_sptr = open_image_data_file(full_data_file_name);
+  istream& data_in = *data_in_sptr;
 
   data_in.seekg(hdr.data_offset_each_dataset[0]);
 
@@ -236,8 +253,8 @@ read_interfile_parametric_image(istream& input, const string& directory_for_data
       = new ParametricVoxelsOnCartesianGrid(ParametricVoxelsOnCartesianGridBaseType(
           hdr.get_exam_info_sptr(), image_sptr->get_index_range(), image_sptr->get_origin(), voxel_size));
 
-  ifstream data_in;
-  open_read_binary(data_in, full_data_file_name);
+  shared_ptr<istream> data_in_sptr = open_image_data_file(full_data_file_name);
+  istream& data_in = *data_in_sptr;
 
   data_in.seekg(hdr.data_offset_each_dataset[0]);
 
@@ -921,6 +938,59 @@ write_basic_interfile(const string& filename,
   return success;
 }
 
+//! Construct a ProjDataFromStream, or a ProjDataFromMappedFile when the file is opened read-only
+/*! If the data file is a ChunkedDataFile, a ProjDataFromChunkedFile is returned. */
+static ProjDataFromStream*
+create_PDFS(shared_ptr<const ExamInfo> const& exam_info_sptr,
+            shared_ptr<const ProjDataInfo> const& proj_data_info_sptr,
+            shared_ptr<iostream> const& data_in,
+            const string& full_data_file_name,
+            const ios::openmode open_mode,
+            const std::streamoff offset,
+            const vector<int>& segment_sequence,
+            const ProjDataFromStream::StorageOrder storage_order,
+            const NumericType type_of_numbers,
+            const ByteOrder byte_order,
+            const float scale_factor)
+{
+  if (ChunkedDataFile::has_signature(full_data_file_name))
+    {
+      if (open_mode & ios::out)
+        error("interfile parsing: data file " + full_data_file_name + " is compressed and cannot be opened for writing");
+      shared_ptr<const ChunkedDataFile> file_sptr(new ChunkedDataFile(full_data_file_name));
+      return new ProjDataFromChunkedFile(exam_info_sptr,
+                                         proj_data_info_sptr,
+                                         file_sptr,
+                                         offset,
+                                         segment_sequence,
+                                         storage_order,
+                                         type_of_numbers,
+                                         byte_order,
+                                         scale_factor);
+    }
+  if (!(open_mode & ios::out) && ProjDataFromMappedFile::is_supported())
+    return new ProjDataFromMappedFile(exam_info_sptr,
+                                      proj_data_info_sptr,
+                                      data_in,
+                                      full_data_file_name,
+                                      open_mode,
+                                      offset,
+                                      segment_sequence,
+                                      storage_order,
+                                      type_of_numbers,
+                                      byte_order,
+                                      scale_factor);
+  return new ProjDataFromStream(exam_info_sptr,
+                                proj_data_info_sptr,
+                                data_in,
+                                offset,
+                                segment_sequence,
+                                storage_order,
+                                type_of_numbers,
+                                byte_order,
+                                scale_factor);
+}
+
 #ifndef MINI_STIR
 
 static ProjDataFromStream*
@@ -955,15 +1025,17 @@ read_interfile_PDFS_SPECT(istream& input, const string& directory_for_data, cons
       return 0;
     }
 
-  return new ProjDataFromStream(hdr.get_exam_info_sptr(),
-                                hdr.data_info_sptr,
-                                data_in,
-                                hdr.data_offset_each_dataset[0],
-                                segment_sequence,
-                                hdr.storage_order,
-                                hdr.type_of_numbers,
-                                hdr.file_byte_order,
-                                static_cast<float>(hdr.image_scaling_factors[0][0]));
+  return create_PDFS(hdr.get_exam_info_sptr(),
+                     hdr.data_info_sptr,
+                     data_in,
+                     full_data_file_name,
+                     open_mode,
+                     hdr.data_offset_each_dataset[0],
+                     segment_sequence,
+                     hdr.storage_order,
+                     hdr.type_of_numbers,
+                     hdr.file_byte_order,
+                     static_cast<float>(hdr.image_scaling_factors[0][0]));
 }
 
 ProjDataFromStream*
@@ -992,15 +1064,17 @@ read_interfile_PDFS_Siemens(istream& input, const string& directory_for_data, co
   if (hdr.compression)
     warning("Siemens projection data is compressed. Reading of raw data will fail.");
 
-  auto pdfs_ptr = new ProjDataFromStream(hdr.get_exam_info_sptr(),
-                                         hdr.data_info_ptr->create_shared_clone(),
-                                         data_in,
-                                         hdr.data_offset_each_dataset[0],
-                                         hdr.segment_sequence,
-                                         hdr.storage_order,
-                                         hdr.type_of_numbers,
-                                         hdr.file_byte_order,
-                                         1.);
+  auto pdfs_ptr = create_PDFS(hdr.get_exam_info_sptr(),
+                              hdr.data_info_ptr->create_shared_clone(),
+                              data_in,
+                              full_data_file_name,
+                              open_mode,
+                              hdr.data_offset_each_dataset[0],
+                              hdr.segment_sequence,
+                              hdr.storage_order,
+                              hdr.type_of_numbers,
+                              hdr.file_byte_order,
+                              1.);
 
   if (hdr.timing_poss_sequence.size() > 1)
     pdfs_ptr->set_timing_poss_sequence_in_stream(hdr.timing_poss_sequence);
@@ -1069,15 +1143,17 @@ read_interfile_PDFS(istream& input, const string& directory_for_data, const ios:
       return 0;
     }
 
-  auto pdfs_ptr = new ProjDataFromStream(hdr.get_exam_info_sptr(),
-                                         hdr.data_info_sptr->create_shared_clone(),
-                                         data_in,
-                                         hdr.data_offset_each_dataset[0],
-                                         hdr.segment_sequence,
-                                         hdr.storage_order,
-                                         hdr.type_of_numbers,
-                                         hdr.file_byte_order,
-                                         static_cast<float>(hdr.image_scaling_factors[0][0]));
+  auto pdfs_ptr = create_PDFS(hdr.get_exam_info_sptr(),
+                              hdr.data_info_sptr->create_shared_clone(),
+                              data_in,
+                              full_data_file_name,
+                              open_mode,
+                              hdr.data_offset_each_dataset[0],
+                              hdr.segment_sequence,
+                              hdr.storage_order,
+                              hdr.type_of_numbers,
+                              hdr.file_byte_order,
+                              static_cast<float>(hdr.image_scaling_factors[0][0]));
 
   if (hdr.timing_poss_sequence.size() > 1)
     pdfs_ptr->set_timing_poss_sequence_in_stream(hdr.timing_poss_sequence);
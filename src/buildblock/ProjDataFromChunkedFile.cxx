@@ -0,0 +1,146 @@
+//
+//
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup projdata
+  \brief Implementation of class stir::ProjDataFromChunkedFile
+*/
+
+#include "stir/ProjDataFromChunkedFile.h"
+#include "stir/IO/ChunkedDataFile.h"
+#include "stir/IO/interfile.h"
+#include "stir/SegmentByView.h"
+#include "stir/Succeeded.h"
+#include "stir/utilities.h"
+#include "stir/error.h"
+#include "stir/warning.h"
+#include "stir/format.h"
+
+START_NAMESPACE_STIR
+
+Succeeded
+ProjDataFromChunkedFile::write_to_file(const std::string& filename,
+                                       const ProjData& proj_data,
+                                       const int compression_level,
+                                       const bool quantise_to_16_bits)
+{
+  std::string data_name = filename;
+  {
+    std::string::size_type pos = find_pos_of_extension(filename);
+    if (pos != std::string::npos && filename.substr(pos) == ".hs")
+      replace_extension(data_name, ".chk");
+    else
+      add_extension(data_name, ".chk");
+  }
+  std::string header_name = data_name;
+  replace_extension(header_name, ".hs");
+
+  // object describing the uncompressed data, used for the header and the order of the data in the file
+  const ProjDataFromStream uncompressed_proj_data(
+      proj_data.get_exam_info_sptr(), proj_data.get_proj_data_info_sptr(), shared_ptr<std::iostream>());
+  std::vector<int> timing_poss_sequence = uncompressed_proj_data.get_timing_poss_sequence_in_stream();
+  if (timing_poss_sequence.empty())
+    timing_poss_sequence.push_back(0);
+
+  ChunkedDataFileWriter writer(data_name, compression_level, quantise_to_16_bits);
+  for (const int timing_pos_num : timing_poss_sequence)
+    for (const int segment_num : uncompressed_proj_data.get_segment_sequence_in_stream())
+      {
+        const SegmentByView<float> segment = proj_data.get_segment_by_view(segment_num, timing_pos_num);
+        // one chunk per viewgram
+        std::vector<std::vector<float>> chunks(segment.get_num_views());
+        for (int view_num = segment.get_min_view_num(); view_num <= segment.get_max_view_num(); ++view_num)
+          {
+            std::vector<float>& chunk = chunks[view_num - segment.get_min_view_num()];
+            chunk.assign(segment[view_num].begin_all_const(), segment[view_num].end_all_const());
+          }
+        if (writer.write_chunks(chunks) == Succeeded::no)
+          {
+            warning(format("ProjDataFromChunkedFile: error writing {}", data_name));
+            return Succeeded::no;
+          }
+      }
+  if (writer.close() == Succeeded::no)
+    return Succeeded::no;
+
+  return write_basic_interfile_PDFS_header(header_name, data_name, uncompressed_proj_data);
+}
+
+ProjDataFromChunkedFile::ProjDataFromChunkedFile(shared_ptr<const ExamInfo> const& exam_info_sptr,
+                                                 shared_ptr<const ProjDataInfo> const& proj_data_info_sptr,
+                                                 shared_ptr<const ChunkedDataFile> const& file_sptr,
+                                                 const std::streamoff offs,
+                                                 const std::vector<int>& segment_sequence_in_stream,
+                                                 StorageOrder o,
+                                                 NumericType data_type,
+                                                 ByteOrder byte_order,
+                                                 float scale_factor)
+    : ProjDataFromStream(exam_info_sptr,
+                         proj_data_info_sptr,
+                         ChunkedDataFile::create_stream(file_sptr),
+                         offs,
+                         segment_sequence_in_stream,
+                         o,
+                         data_type,
+                         byte_order,
+                         scale_factor),
+      file_sptr(file_sptr)
+{}
+
+Succeeded
+ProjDataFromChunkedFile::read_from_stream(const std::function<Succeeded(std::istream&)>& read_function) const
+{
+  shared_ptr<std::iostream> s = ChunkedDataFile::create_stream(this->file_sptr);
+  try
+    {
+      return read_function(*s);
+    }
+  catch (...)
+    {
+      return Succeeded::no;
+    }
+}
+
+Succeeded
+ProjDataFromChunkedFile::set_viewgram(const Viewgram<float>&)
+{
+  error("ProjDataFromChunkedFile: data are read-only");
+  return Succeeded::no;
+}
+
+Succeeded
+ProjDataFromChunkedFile::set_sinogram(const Sinogram<float>&)
+{
+  error("ProjDataFromChunkedFile: data are read-only");
+  return Succeeded::no;
+}
+
+Succeeded
+ProjDataFromChunkedFile::set_segment(const SegmentBySinogram<float>&)
+{
+  error("ProjDataFromChunkedFile: data are read-only");
+  return Succeeded::no;
+}
+
+Succeeded
+ProjDataFromChunkedFile::set_segment(const SegmentByView<float>&)
+{
+  error("ProjDataFromChunkedFile: data are read-only");
+  return Succeeded::no;
+}
+
+void
+ProjDataFromChunkedFile::set_bin_value(const Bin&)
+{
+  error("ProjDataFromChunkedFile: data are read-only");
+}
+
+END_NAMESPACE_STIR
@@ -0,0 +1,234 @@
+//
+//
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup projdata
+  \brief Implementation of class stir::ProjDataFromMappedFile
+*/
+
+#include "stir/ProjDataFromMappedFile.h"
+#include "stir/Succeeded.h"
+#include "stir/Bin.h"
+#include "stir/error.h"
+#include "stir/warning.h"
+#include "stir/format.h"
+#include "stir/is_null_ptr.h"
+#include <streambuf>
+#include <algorithm>
+#ifdef HAVE_SYSTEM_MMAP
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+START_NAMESPACE_STIR
+
+namespace detail
+{
+//! read-only stream buffer over a block of memory (supporting seeks)
+class MemoryStreamBuffer : public std::streambuf
+{
+public:
+  MemoryStreamBuffer(const char* data, const std::size_t size)
+  {
+    char* start = const_cast<char*>(data);
+    this->setg(start, start, start + size);
+  }
+
+protected:
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+  {
+    if (!(which & std::ios_base::in))
+      return pos_type(off_type(-1));
+    char* base;
+    if (dir == std::ios_base::beg)
+      base = this->eback();
+    else if (dir == std::ios_base::cur)
+      base = this->gptr();
+    else
+      base = this->egptr();
+    if (off < this->eback() - base || off > this->egptr() - base)
+      return pos_type(off_type(-1));
+    this->setg(this->eback(), base + off, this->egptr());
+    return pos_type(this->gptr() - this->eback());
+  }
+
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+  {
+    return this->seekoff(off_type(pos), std::ios_base::beg, which);
+  }
+};
+} // namespace detail
+
+//! holds the memory-mapped file
+class ProjDataFromMappedFile::Mapping
+{
+public:
+  Mapping()
+      : data(nullptr),
+        size(0)
+  {}
+
+  ~Mapping()
+  {
+#ifdef HAVE_SYSTEM_MMAP
+    if (data != nullptr)
+      munmap(const_cast<char*>(data), size);
+#endif
+  }
+
+  //! map the file, returns false if this failed
+  bool map(const std::string& filename)
+  {
+#ifdef HAVE_SYSTEM_MMAP
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0)
+      {
+        close(fd);
+        return false;
+      }
+    void* ptr = mmap(nullptr, static_cast<std::size_t>(file_stat.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    // the mapping stays valid after closing the file descriptor
+    close(fd);
+    if (ptr == MAP_FAILED)
+      return false;
+    data = static_cast<const char*>(ptr);
+    size = static_cast<std::size_t>(file_stat.st_size);
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  const char* data;
+  std::size_t size;
+};
+
+bool
+ProjDataFromMappedFile::is_supported()
+{
+#ifdef HAVE_SYSTEM_MMAP
+  return true;
+#else
+  return false;
+#endif
+}
+
+ProjDataFromMappedFile::ProjDataFromMappedFile(shared_ptr<const ExamInfo> const& exam_info_sptr,
+                                               shared_ptr<const ProjDataInfo> const& proj_data_info_sptr,
+                                               shared_ptr<std::iostream> const& s,
+                                               const std::string& filename,
+                                               const std::ios::openmode open_mode,
+                                               const std::streamoff offs,
+                                               const std::vector<int>& segment_sequence_in_stream,
+                                               StorageOrder o,
+                                               NumericType data_type,
+                                               ByteOrder byte_order,
+                                               float scale_factor)
+    : ProjDataFromStream(exam_info_sptr,
+                         proj_data_info_sptr,
+                         s,
+                         offs,
+                         segment_sequence_in_stream,
+                         o,
+                         data_type,
+                         byte_order,
+                         scale_factor)
+{
+  // writing goes via the stream, so we only map read-only files to avoid coherency problems
+  if (!(open_mode & std::ios::out) && is_supported())
+    {
+      shared_ptr<Mapping> new_mapping_sptr(new Mapping);
+      if (new_mapping_sptr->map(filename))
+        this->mapping_sptr = new_mapping_sptr;
+      else
+        warning(format("ProjDataFromMappedFile: could not map file {} into memory. Reading via the stream instead.", filename));
+    }
+}
+
+ProjDataFromMappedFile::~ProjDataFromMappedFile()
+{}
+
+bool
+ProjDataFromMappedFile::is_mapped() const
+{
+  return !is_null_ptr(this->mapping_sptr);
+}
+
+Succeeded
+ProjDataFromMappedFile::read_from_stream(const std::function<Succeeded(std::istream&)>& read_function) const
+{
+  if (!this->is_mapped())
+    return ProjDataFromStream::read_from_stream(read_function);
+
+  // every call gets its own stream, such that we do not need to lock
+  detail::MemoryStreamBuffer buffer(this->mapping_sptr->data, this->mapping_sptr->size);
+  std::istream s(&buffer);
+  try
+    {
+      return read_function(s);
+    }
+  catch (...)
+    {
+      return Succeeded::no;
+    }
+}
+
+void
+ProjDataFromMappedFile::prefetch_range(const std::streamoff start, const std::streamoff length) const
+{
+#ifdef HAVE_SYSTEM_MMAP
+  if (length <= 0)
+    return;
+  // madvise needs an address aligned to the page size
+  const std::streamoff page_size = static_cast<std::streamoff>(sysconf(_SC_PAGESIZE));
+  const std::streamoff aligned_start = (start / page_size) * page_size;
+  const std::streamoff end = std::min(start + length, static_cast<std::streamoff>(this->mapping_sptr->size));
+  if (end <= aligned_start)
+    return;
+  madvise(const_cast<char*>(this->mapping_sptr->data + aligned_start),
+          static_cast<std::size_t>(end - aligned_start),
+          MADV_WILLNEED);
+#endif
+}
+
+void
+ProjDataFromMappedFile::prefetch_viewgram(const int view_num, const int segment_num, const int timing_pos) const
+{
+  if (!this->is_mapped())
+    return;
+
+  const std::streamoff row_length
+      = static_cast<std::streamoff>(this->get_num_tangential_poss()) * this->get_data_type_in_stream().size_in_bytes();
+  const int min_axial_pos_num = this->get_min_axial_pos_num(segment_num);
+  const int max_axial_pos_num = this->get_max_axial_pos_num(segment_num);
+  const int min_tangential_pos_num = this->get_min_tangential_pos_num();
+  if (this->get_storage_order() == Segment_View_AxialPos_TangPos
+      || this->get_storage_order() == Timing_Segment_View_AxialPos_TangPos)
+    {
+      // viewgram is contiguous
+      const std::streamoff start
+          = this->get_offset(Bin(segment_num, view_num, min_axial_pos_num, min_tangential_pos_num, timing_pos));
+      this->prefetch_range(start, row_length * (max_axial_pos_num - min_axial_pos_num + 1));
+    }
+  else
+    {
+      for (int ax_pos_num = min_axial_pos_num; ax_pos_num <= max_axial_pos_num; ++ax_pos_num)
+        this->prefetch_range(this->get_offset(Bin(segment_num, view_num, ax_pos_num, min_tangential_pos_num, timing_pos)),
+                             row_length);
+    }
+}
+
+END_NAMESPACE_STIR
@@ -13,7 +13,7 @@
     Copyright (C) 2000 PARAPET partners
     Copyright (C) 2000 - 2011-12-21, Hammersmith Imanet Ltd
     Copyright (C) 2011-2012, Kris Thielemans
-    Copyright (C) 2013, 2017, 2022, 2023 University College London
+    Copyright (C) 2013, 2017, 2022, 2023, 2026 University College London
     Copyright (C) 2016, University of Hull
 
     This file is part of STIR.
@@ -53,6 +53,26 @@ using std::endl;
 using std::vector;
 
 START_NAMESPACE_STIR
+
+Succeeded
+ProjDataFromStream::read_from_stream(const std::function<Succeeded(std::istream&)>& read_function) const
+{
+  Succeeded succeeded = Succeeded::yes;
+#ifdef STIR_OPENMP
+#  pragma omp critical(PROJDATAFROMSTREAMIO)
+#endif
+  try
+    {
+      succeeded = read_function(*sino_stream);
+    }
+  catch (...)
+    {
+      succeeded = Succeeded::no;
+    }
+  // end of critical section
+  return succeeded;
+}
+
 //---------------------------------------------------------
 // constructors
 //---------------------------------------------------------
@@ -195,44 +215,34 @@ ProjDataFromStream::get_viewgram(const int view_num,
   Succeeded succeeded = Succeeded::yes;
   Bin bin(segment_num, view_num, this->get_min_axial_pos_num(segment_num), this->get_min_tangential_pos_num(), timing_pos);
 
-#ifdef STIR_OPENMP
-#  pragma omp critical(PROJDATAFROMSTREAMIO)
-#endif
-  try
-    {
-      if (get_storage_order() == Segment_AxialPos_View_TangPos || get_storage_order() == Timing_Segment_AxialPos_View_TangPos)
-        {
-          for (bin.axial_pos_num() = get_min_axial_pos_num(segment_num);
-               bin.axial_pos_num() <= get_max_axial_pos_num(segment_num);
-               bin.axial_pos_num()++)
-            {
-              detail::checked_seekg("get_viewgram", *sino_stream, get_offset(bin));
-              if ((succeeded
-                   = read_data(*sino_stream, viewgram[bin.axial_pos_num()], on_disk_data_type, scale, on_disk_byte_order))
-                  == Succeeded::no)
-                break;
-              if (scale != 1)
-                break;
-            }
-        }
-      else if (get_storage_order() == Segment_View_AxialPos_TangPos
-               || get_storage_order() == Timing_Segment_View_AxialPos_TangPos)
-        {
-          // read in one go (skipping the extra seek)
-          detail::checked_seekg("get_viewgram", *sino_stream, get_offset(bin));
-          succeeded = read_data(*sino_stream, viewgram, on_disk_data_type, scale, on_disk_byte_order);
-        }
-      else
-        {
-          warning("ProjDataFromStream::get_viewgram: unsupported storage order");
-          succeeded = Succeeded::no;
-        }
-    }
-  catch (...)
-    {
-      succeeded = Succeeded::no;
-    }
-  // end of critical section
+  succeeded = this->read_from_stream([&](std::istream& s) {
+    if (get_storage_order() == Segment_AxialPos_View_TangPos || get_storage_order() == Timing_Segment_AxialPos_View_TangPos)
+      {
+        for (bin.axial_pos_num() = get_min_axial_pos_num(segment_num);
+             bin.axial_pos_num() <= get_max_axial_pos_num(segment_num);
+             bin.axial_pos_num()++)
+          {
+            detail::checked_seekg("get_viewgram", s, get_offset(bin));
+            if ((succeeded = read_data(s, viewgram[bin.axial_pos_num()], on_disk_data_type, scale, on_disk_byte_order))
+                == Succeeded::no)
+              break;
+            if (scale != 1)
+              break;
+          }
+      }
+    else if (get_storage_order() == Segment_View_AxialPos_TangPos || get_storage_order() == Timing_Segment_View_AxialPos_TangPos)
+      {
+        // read in one go (skipping the extra seek)
+        detail::checked_seekg("get_viewgram", s, get_offset(bin));
+        succeeded = read_data(s, viewgram, on_disk_data_type, scale, on_disk_byte_order);
+      }
+    else
+      {
+        warning("ProjDataFromStream::get_viewgram: unsupported storage order");
+        succeeded = Succeeded::no;
+      }
+    return succeeded;
+  });
   if (scale != 1)
     error("ProjDataFromStream: error reading data: scale factor returned by read_data should be 1");
   if (succeeded == Succeeded::no)
@@ -266,291 +276,283 @@ ProjDataFromStream::get_bin_value(const Bin& this_bin) const
       error("ProjDataFromStream::get_bin_value: error in stream state before reading\n");
     }
 
-  detail::checked_seekg("get_bin_value", *sino_stream, get_offset(this_bin));
-
   Array<1, float> value(1);
   float scale = float(1);
 
-  if (read_data(*sino_stream, value, on_disk_data_type, scale, on_disk_byte_order) == Succeeded::no)
-    error("ProjDataFromStream: error reading data\n");
-  if (scale != 1.f)
-    error("ProjDataFromStream: error reading data: scale factor returned by read_data should be 1\n");
+  const Succeeded succeeded = this->read_from_stream([&](std::istream& s) {
+  detail::checked_seekg("get_bin_value", s, get_offset(this_bin));
+  return read_data(s, value, on_disk_data_type, scale, on_disk_byte_order);
+});
+if (succeeded == Succeeded::no)
+  error("ProjDataFromStream: error reading data\n");
+if (scale != 1.f)
+  error("ProjDataFromStream: error reading data: scale factor returned by read_data should be 1\n");
 
-  value *= scale_factor;
+value *= scale_factor;
 
-  return value[0];
+return value[0];
 }
 
 void
 ProjDataFromStream::set_bin_value(const Bin& this_bin)
 {
-  if (is_null_ptr(sino_stream))
-    {
-      error("ProjDataFromStream::set_bin_value: stream ptr is 0\n");
-    }
-  if (!*sino_stream)
-    {
-      error("ProjDataFromStream::set_bin_value: error in stream state before writing");
-    }
-
-  detail::checked_seekp("set_bin_value", *sino_stream, get_offset(this_bin));
-
-  Array<1, float> value(1);
-  value[0] = this_bin.get_bin_value();
-  float scale = float(1);
-  // Now the storage order is not more important. Just read.
-  if (write_data(*sino_stream, value, on_disk_data_type, scale, on_disk_byte_order) == Succeeded::no)
-    error("ProjDataFromStream: error writing data\n");
-  if (scale != 1.f)
-    error("ProjDataFromStream: error writing data: scale factor returned by write_data should be 1\n");
+if (is_null_ptr(sino_stream))
+  {
+    error("ProjDataFromStream::set_bin_value: stream ptr is 0\n");
+  }
+if (!*sino_stream)
+  {
+    error("ProjDataFromStream::set_bin_value: error in stream state before writing");
+  }
+
+detail::checked_seekp("set_bin_value", *sino_stream, get_offset(this_bin));
+
+Array<1, float> value(1);
+value[0] = this_bin.get_bin_value();
+float scale = float(1);
+// Now the storage order is not more important. Just read.
+if (write_data(*sino_stream, value, on_disk_data_type, scale, on_disk_byte_order) == Succeeded::no)
+  error("ProjDataFromStream: error writing data\n");
+if (scale != 1.f)
+  error("ProjDataFromStream: error writing data: scale factor returned by write_data should be 1\n");
 }
 
 Succeeded
 ProjDataFromStream::set_viewgram(const Viewgram<float>& v)
 {
-  if (is_null_ptr(sino_stream))
-    {
-      warning("ProjDataFromStream::set_viewgram: stream ptr is 0\n");
-      return Succeeded::no;
-    }
-  if (!*sino_stream)
-    {
-      warning("ProjDataFromStream::set_viewgram: error in stream state before writing\n");
-      return Succeeded::no;
-    }
-
-  // KT 03/07/2001 modified handling of scale_factor etc.
-  if (on_disk_data_type.id != NumericType::FLOAT)
-    {
-      warning("ProjDataFromStream::set_viewgram: non-float output uses original "
-              "scale factor %g which might not be appropriate for the current data\n",
-              scale_factor);
-    }
-
-  if (get_num_tangential_poss() != v.get_proj_data_info_sptr()->get_num_tangential_poss())
-    {
-      warning("ProjDataFromStream::set_viewgram: num_bins is not correct\n");
-      return Succeeded::no;
-    }
-
-  if (get_num_axial_poss(v.get_segment_num()) != v.get_num_axial_poss())
-    {
-      warning("ProjDataFromStream::set_viewgram: number of axial positions is not correct\n");
-      return Succeeded::no;
-    }
-
-  if (*get_proj_data_info_sptr() != *(v.get_proj_data_info_sptr()))
-    {
-      warning("ProjDataFromStream::set_viewgram: viewgram has incompatible ProjDataInfo member\n"
-              "Original ProjDataInfo: %s\n"
-              "ProjDataInfo From viewgram: %s",
-              this->get_proj_data_info_sptr()->parameter_info().c_str(),
-              v.get_proj_data_info_sptr()->parameter_info().c_str());
-
-      return Succeeded::no;
-    }
-  const int segment_num = v.get_segment_num();
-  const int view_num = v.get_view_num();
-  const int timing_pos = v.get_timing_pos_num();
-  Bin bin(segment_num, view_num, this->get_min_axial_pos_num(segment_num), this->get_min_tangential_pos_num(), timing_pos);
-
-  float scale = scale_factor;
-  Succeeded succeeded = Succeeded::yes;
+if (is_null_ptr(sino_stream))
+  {
+    warning("ProjDataFromStream::set_viewgram: stream ptr is 0\n");
+    return Succeeded::no;
+  }
+if (!*sino_stream)
+  {
+    warning("ProjDataFromStream::set_viewgram: error in stream state before writing\n");
+    return Succeeded::no;
+  }
+
+// KT 03/07/2001 modified handling of scale_factor etc.
+if (on_disk_data_type.id != NumericType::FLOAT)
+  {
+    warning("ProjDataFromStream::set_viewgram: non-float output uses original "
+            "scale factor %g which might not be appropriate for the current data\n",
+            scale_factor);
+  }
+
+if (get_num_tangential_poss() != v.get_proj_data_info_sptr()->get_num_tangential_poss())
+  {
+    warning("ProjDataFromStream::set_viewgram: num_bins is not correct\n");
+    return Succeeded::no;
+  }
+
+if (get_num_axial_poss(v.get_segment_num()) != v.get_num_axial_poss())
+  {
+    warning("ProjDataFromStream::set_viewgram: number of axial positions is not correct\n");
+    return Succeeded::no;
+  }
+
+if (*get_proj_data_info_sptr() != *(v.get_proj_data_info_sptr()))
+  {
+    warning("ProjDataFromStream::set_viewgram: viewgram has incompatible ProjDataInfo member\n"
+            "Original ProjDataInfo: %s\n"
+            "ProjDataInfo From viewgram: %s",
+            this->get_proj_data_info_sptr()->parameter_info().c_str(),
+            v.get_proj_data_info_sptr()->parameter_info().c_str());
+
+    return Succeeded::no;
+  }
+const int segment_num = v.get_segment_num();
+const int view_num = v.get_view_num();
+const int timing_pos = v.get_timing_pos_num();
+Bin bin(segment_num, view_num, this->get_min_axial_pos_num(segment_num), this->get_min_tangential_pos_num(), timing_pos);
+
+float scale = scale_factor;
+Succeeded succeeded = Succeeded::yes;
 
 #ifdef STIR_OPENMP
 #  pragma omp critical(PROJDATAFROMSTREAMIO)
 #endif
-  try
-    {
-      if (get_storage_order() == Segment_AxialPos_View_TangPos || get_storage_order() == Timing_Segment_AxialPos_View_TangPos)
-        {
-          for (bin.axial_pos_num() = get_min_axial_pos_num(segment_num);
-               bin.axial_pos_num() <= get_max_axial_pos_num(segment_num);
-               bin.axial_pos_num()++)
-            {
-              detail::checked_seekp("set_viewgram", *sino_stream, get_offset(bin));
-              if (write_data(*sino_stream, v[bin.axial_pos_num()], on_disk_data_type, scale, on_disk_byte_order) == Succeeded::no
-                  || scale != scale_factor)
-                {
-                  succeeded = Succeeded::no;
-                  break;
-                }
-            }
-        }
-      else if (get_storage_order() == Segment_View_AxialPos_TangPos
-               || get_storage_order() == Timing_Segment_View_AxialPos_TangPos)
-        {
-          // write in one go (skipping the extra seek)
-          detail::checked_seekp("set_viewgram", *sino_stream, get_offset(bin));
-          if (write_data(*sino_stream, v, on_disk_data_type, scale, on_disk_byte_order) == Succeeded::no || scale != scale_factor)
-            {
-              succeeded = Succeeded::no;
-            }
-        }
-      else
-        {
-          warning("ProjDataFromStream::set_viewgram: unsupported storage order");
-          succeeded = Succeeded::no;
-        }
-      // flush the stream, see the class documentation
-      sino_stream->flush();
-    }
-  catch (...)
-    {
-      succeeded = Succeeded::no;
-    }
-  // end of critical section
-  if (succeeded == Succeeded::no)
-    error("ProjDataFromStream::set_viewgram: viewgram (view=%d, segment=%d, timing_pos=%d)"
-          " corrupted due to problems with writing or the scale factor (out of disk space?)",
-          view_num,
-          segment_num,
-          timing_pos);
-
-  return succeeded;
+try
+  {
+    if (get_storage_order() == Segment_AxialPos_View_TangPos || get_storage_order() == Timing_Segment_AxialPos_View_TangPos)
+      {
+        for (bin.axial_pos_num() = get_min_axial_pos_num(segment_num);
+             bin.axial_pos_num() <= get_max_axial_pos_num(segment_num);
+             bin.axial_pos_num()++)
+          {
+            detail::checked_seekp("set_viewgram", *sino_stream, get_offset(bin));
+            if (write_data(*sino_stream, v[bin.axial_pos_num()], on_disk_data_type, scale, on_disk_byte_order) == Succeeded::no
+                || scale != scale_factor)
+              {
+                succeeded = Succeeded::no;
+                break;
+              }
+          }
+      }
+    else if (get_storage_order() == Segment_View_AxialPos_TangPos || get_storage_order() == Timing_Segment_View_AxialPos_TangPos)
+      {
+        // write in one go (skipping the extra seek)
+        detail::checked_seekp("set_viewgram", *sino_stream, get_offset(bin));
+        if (write_data(*sino_stream, v, on_disk_data_type, scale, on_disk_byte_order) == Succeeded::no || scale != scale_factor)
+          {
+            succeeded = Succeeded::no;
+          }
+      }
+    else
+      {
+        warning("ProjDataFromStream::set_viewgram: unsupported storage order");
+        succeeded = Succeeded::no;
+      }
+    // flush the stream, see the class documentation
+    sino_stream->flush();
+  }
+catch (...)
+  {
+    succeeded = Succeeded::no;
+  }
+// end of critical section
+if (succeeded == Succeeded::no)
+  error("ProjDataFromStream::set_viewgram: viewgram (view=%d, segment=%d, timing_pos=%d)"
+        " corrupted due to problems with writing or the scale factor (out of disk space?)",
+        view_num,
+        segment_num,
+        timing_pos);
+
+return succeeded;
 }
 
 std::streamoff
 ProjDataFromStream::get_offset(const Bin& this_bin) const
 {
 
-  if (!(this_bin.segment_num() >= get_min_segment_num() && this_bin.segment_num() <= get_max_segment_num()))
-    error("ProjDataFromStream::get_offset: segment_num out of range : %d", this_bin.segment_num());
+if (!(this_bin.segment_num() >= get_min_segment_num() && this_bin.segment_num() <= get_max_segment_num()))
+  error("ProjDataFromStream::get_offset: segment_num out of range : %d", this_bin.segment_num());
 
-  if (!(this_bin.axial_pos_num() >= get_min_axial_pos_num(this_bin.segment_num())
-        && this_bin.axial_pos_num() <= get_max_axial_pos_num(this_bin.segment_num())))
-    error("ProjDataFromStream::get_offset: axial_pos_num out of range : %d", this_bin.axial_pos_num());
-  if (!(this_bin.timing_pos_num() >= get_min_tof_pos_num() && this_bin.timing_pos_num() <= get_max_tof_pos_num()))
-    error("ProjDataFromStream::get_offset: timing_num out of range : %d", this_bin.timing_pos_num());
+if (!(this_bin.axial_pos_num() >= get_min_axial_pos_num(this_bin.segment_num())
+      && this_bin.axial_pos_num() <= get_max_axial_pos_num(this_bin.segment_num())))
+  error("ProjDataFromStream::get_offset: axial_pos_num out of range : %d", this_bin.axial_pos_num());
+if (!(this_bin.timing_pos_num() >= get_min_tof_pos_num() && this_bin.timing_pos_num() <= get_max_tof_pos_num()))
+  error("ProjDataFromStream::get_offset: timing_num out of range : %d", this_bin.timing_pos_num());
 
-  const int index = static_cast<int>(std::find(segment_sequence.begin(), segment_sequence.end(), this_bin.segment_num())
-                                     - segment_sequence.begin());
+const int index = static_cast<int>(std::find(segment_sequence.begin(), segment_sequence.end(), this_bin.segment_num())
+                                   - segment_sequence.begin());
 
-  streamoff num_axial_pos_offset = 0;
+streamoff num_axial_pos_offset = 0;
 
-  for (int i = 0; i < index; i++)
-    num_axial_pos_offset += get_num_axial_poss(segment_sequence[i]);
+for (int i = 0; i < index; i++)
+  num_axial_pos_offset += get_num_axial_poss(segment_sequence[i]);
 
-  streamoff segment_offset = offset
-                             + static_cast<streamoff>(num_axial_pos_offset * get_num_tangential_poss() * get_num_views()
-                                                      * on_disk_data_type.size_in_bytes());
+streamoff segment_offset = offset
+                           + static_cast<streamoff>(num_axial_pos_offset * get_num_tangential_poss() * get_num_views()
+                                                    * on_disk_data_type.size_in_bytes());
 
-  // Now we are just in front of  the correct segment
-  if (get_storage_order() == Segment_AxialPos_View_TangPos || get_storage_order() == Timing_Segment_AxialPos_View_TangPos)
-    {
-      if (proj_data_info_sptr->get_num_tof_poss() > 1)
-        {
-          // The timing offset will be added to the segment offset to minimise the changes
-          const int timing_index
-              = static_cast<int>(std::find(timing_poss_sequence.begin(), timing_poss_sequence.end(), this_bin.timing_pos_num())
-                                 - timing_poss_sequence.begin());
-
-          assert(offset_3d_data > 0);
-          segment_offset += static_cast<streamoff>(timing_index) * offset_3d_data;
-        }
-      // skip axial positions
-      const streamoff ax_pos_offset = (this_bin.axial_pos_num() - get_min_axial_pos_num(this_bin.segment_num())) * get_num_views()
-                                      * get_num_tangential_poss() * on_disk_data_type.size_in_bytes();
+// Now we are just in front of  the correct segment
+if (get_storage_order() == Segment_AxialPos_View_TangPos || get_storage_order() == Timing_Segment_AxialPos_View_TangPos)
+  {
+    if (proj_data_info_sptr->get_num_tof_poss() > 1)
+      {
+        // The timing offset will be added to the segment offset to minimise the changes
+        const int timing_index
+            = static_cast<int>(std::find(timing_poss_sequence.begin(), timing_poss_sequence.end(), this_bin.timing_pos_num())
+                               - timing_poss_sequence.begin());
 
-      // sinogram location
+        assert(offset_3d_data > 0);
+        segment_offset += static_cast<streamoff>(timing_index) * offset_3d_data;
+      }
+    // skip axial positions
+    const streamoff ax_pos_offset = (this_bin.axial_pos_num() - get_min_axial_pos_num(this_bin.segment_num())) * get_num_views()
+                                    * get_num_tangential_poss() * on_disk_data_type.size_in_bytes();
 
-      // find view
-      const streamoff view_offset
-          = (this_bin.view_num() - get_min_view_num()) * get_num_tangential_poss() * on_disk_data_type.size_in_bytes();
+    // sinogram location
 
-      // find tang pos
-      const streamoff tang_offset
-          = (this_bin.tangential_pos_num() - get_min_tangential_pos_num()) * on_disk_data_type.size_in_bytes();
+    // find view
+    const streamoff view_offset
+        = (this_bin.view_num() - get_min_view_num()) * get_num_tangential_poss() * on_disk_data_type.size_in_bytes();
 
-      return segment_offset + ax_pos_offset + view_offset + tang_offset;
-    }
-  else if (get_storage_order() == Segment_View_AxialPos_TangPos || get_storage_order() == Timing_Segment_View_AxialPos_TangPos)
-    {
-      if (proj_data_info_sptr->get_num_tof_poss() > 1)
-        {
-          // The timing offset will be added to the segment offset. This approach we minimise the changes
-          const int timing_index
-              = static_cast<int>(std::find(timing_poss_sequence.begin(), timing_poss_sequence.end(), this_bin.timing_pos_num())
-                                 - timing_poss_sequence.begin());
+    // find tang pos
+    const streamoff tang_offset
+        = (this_bin.tangential_pos_num() - get_min_tangential_pos_num()) * on_disk_data_type.size_in_bytes();
 
-          assert(offset_3d_data > 0);
-          segment_offset += static_cast<streamoff>(timing_index) * offset_3d_data;
-        }
-      // Skip views
-      const streamoff view_offset = (this_bin.view_num() - get_min_view_num()) * get_num_axial_poss(this_bin.segment_num())
-                                    * get_num_tangential_poss() * on_disk_data_type.size_in_bytes();
+    return segment_offset + ax_pos_offset + view_offset + tang_offset;
+  }
+else if (get_storage_order() == Segment_View_AxialPos_TangPos || get_storage_order() == Timing_Segment_View_AxialPos_TangPos)
+  {
+    if (proj_data_info_sptr->get_num_tof_poss() > 1)
+      {
+        // The timing offset will be added to the segment offset. This approach we minimise the changes
+        const int timing_index
+            = static_cast<int>(std::find(timing_poss_sequence.begin(), timing_poss_sequence.end(), this_bin.timing_pos_num())
+                               - timing_poss_sequence.begin());
 
-      // find axial pos
-      const streamoff ax_pos_offset = (this_bin.axial_pos_num() - get_min_axial_pos_num(this_bin.segment_num()))
-                                      * get_num_tangential_poss() * on_disk_data_type.size_in_bytes();
+        assert(offset_3d_data > 0);
+        segment_offset += static_cast<streamoff>(timing_index) * offset_3d_data;
+      }
+    // Skip views
+    const streamoff view_offset = (this_bin.view_num() - get_min_view_num()) * get_num_axial_poss(this_bin.segment_num())
+                                  * get_num_tangential_poss() * on_disk_data_type.size_in_bytes();
 
-      // find tang pos
-      const streamoff tang_offset
-          = (this_bin.tangential_pos_num() - get_min_tangential_pos_num()) * on_disk_data_type.size_in_bytes();
+    // find axial pos
+    const streamoff ax_pos_offset = (this_bin.axial_pos_num() - get_min_axial_pos_num(this_bin.segment_num()))
+                                    * get_num_tangential_poss() * on_disk_data_type.size_in_bytes();
 
-      return segment_offset + ax_pos_offset + view_offset + tang_offset;
-    }
-  else
-    {
-      error("ProjDataFromStream::get_offset: unsupported storage order");
-      return streamoff(0); // return something to avoid compiler warning
-    }
+    // find tang pos
+    const streamoff tang_offset
+        = (this_bin.tangential_pos_num() - get_min_tangential_pos_num()) * on_disk_data_type.size_in_bytes();
+
+    return segment_offset + ax_pos_offset + view_offset + tang_offset;
+  }
+else
+  {
+    error("ProjDataFromStream::get_offset: unsupported storage order");
+    return streamoff(0); // return something to avoid compiler warning
+  }
 }
 
 Sinogram<float>
 ProjDataFromStream::get_sinogram(const int ax_pos_num,
-                                 const int segment_num,
-                                 const bool make_num_tangential_poss_odd,
-                                 const int timing_pos) const
+                               const int segment_num,
+                               const bool make_num_tangential_poss_odd,
+                               const int timing_pos) const
 {
-  if (is_null_ptr(sino_stream))
-    {
-      error("ProjDataFromStream::get_sinogram: stream ptr is 0");
-    }
-  if (!*sino_stream)
-    {
-      error("ProjDataFromStream::get_sinogram: error in stream state before reading");
-    }
-
-  Sinogram<float> sinogram(proj_data_info_sptr, ax_pos_num, segment_num, timing_pos);
-  float scale = float(1);
-  Succeeded succeeded = Succeeded::yes;
-  Bin bin(segment_num, this->get_min_view_num(), ax_pos_num, this->get_min_tangential_pos_num(), timing_pos);
-
-#ifdef STIR_OPENMP
-#  pragma omp critical(PROJDATAFROMSTREAMIO)
-#endif
-  try
-    {
-      if (get_storage_order() == Segment_AxialPos_View_TangPos || get_storage_order() == Timing_Segment_AxialPos_View_TangPos)
-        {
-          detail::checked_seekg("get_sinogram", *sino_stream, get_offset(bin));
-          succeeded = read_data(*sino_stream, sinogram, on_disk_data_type, scale, on_disk_byte_order);
-        }
-      else if (get_storage_order() == Segment_View_AxialPos_TangPos
-               || get_storage_order() == Timing_Segment_View_AxialPos_TangPos)
-        {
-          for (bin.view_num() = get_min_view_num(); bin.view_num() <= get_max_view_num(); bin.view_num()++)
-            {
-              detail::checked_seekg("get_sinogram", *sino_stream, get_offset(bin));
-              if ((succeeded = read_data(*sino_stream, sinogram[bin.view_num()], on_disk_data_type, scale, on_disk_byte_order))
-                  == Succeeded::no)
-                break;
-              if (scale != 1)
-                break;
-            }
-        }
-      else
-        {
-          warning("ProjDataFromStream::get_sinogram: unsupported storage order");
-          succeeded = Succeeded::no;
-        }
-    }
-  catch (...)
-    {
-      succeeded = Succeeded::no;
-    }
-  // end of critical section
+if (is_null_ptr(sino_stream))
+  {
+    error("ProjDataFromStream::get_sinogram: stream ptr is 0");
+  }
+if (!*sino_stream)
+  {
+    error("ProjDataFromStream::get_sinogram: error in stream state before reading");
+  }
+
+Sinogram<float> sinogram(proj_data_info_sptr, ax_pos_num, segment_num, timing_pos);
+float scale = float(1);
+Succeeded succeeded = Succeeded::yes;
+Bin bin(segment_num, this->get_min_view_num(), ax_pos_num, this->get_min_tangential_pos_num(), timing_pos);
+
+  succeeded = this->read_from_stream([&](std::istream& s) {
+    if (get_storage_order() == Segment_AxialPos_View_TangPos || get_storage_order() == Timing_Segment_AxialPos_View_TangPos)
+      {
+        detail::checked_seekg("get_sinogram", s, get_offset(bin));
+        succeeded = read_data(s, sinogram, on_disk_data_type, scale, on_disk_byte_order);
+      }
+    else if (get_storage_order() == Segment_View_AxialPos_TangPos || get_storage_order() == Timing_Segment_View_AxialPos_TangPos)
+      {
+        for (bin.view_num() = get_min_view_num(); bin.view_num() <= get_max_view_num(); bin.view_num()++)
+          {
+            detail::checked_seekg("get_sinogram", s, get_offset(bin));
+            if ((succeeded = read_data(s, sinogram[bin.view_num()], on_disk_data_type, scale, on_disk_byte_order))
+                == Succeeded::no)
+              break;
+            if (scale != 1)
+              break;
+          }
+      }
+    else
+      {
+        warning("ProjDataFromStream::get_sinogram: unsupported storage order");
+        succeeded = Succeeded::no;
+      }
+    return succeeded;
+  });
   if (scale != 1)
     error("ProjDataFromStream: error reading data: scale factor returned by read_data should be 1");
   if (succeeded == Succeeded::no)
@@ -679,19 +681,11 @@ ProjDataFromStream::get_segment_by_sinogram(const int segment_num, const int tim
                     this->get_min_axial_pos_num(segment_num),
                     this->get_min_tangential_pos_num(),
                     timing_num);
-#ifdef STIR_OPENMP
-#  pragma omp critical(PROJDATAFROMSTREAMIO)
-#endif
-      try
-        {
-          detail::checked_seekg("get_segment_by_sinogram", *sino_stream, get_offset(bin));
-          succeeded = read_data(*sino_stream, segment, on_disk_data_type, scale, on_disk_byte_order);
-        }
-      catch (...)
-        {
-          succeeded = Succeeded::no;
-        }
-      // end of critical section
+      succeeded = this->read_from_stream([&](std::istream& s) {
+        detail::checked_seekg("get_segment_by_sinogram", s, get_offset(bin));
+        succeeded = read_data(s, segment, on_disk_data_type, scale, on_disk_byte_order);
+        return succeeded;
+      });
       if (succeeded == Succeeded::no)
         error("ProjDataFromStream: error reading data\n");
       if (scale != 1)
@@ -729,19 +723,11 @@ ProjDataFromStream::get_segment_by_view(const int segment_num, const int timing_
                     this->get_min_axial_pos_num(segment_num),
                     this->get_min_tangential_pos_num(),
                     timing_pos);
-#ifdef STIR_OPENMP
-#  pragma omp critical(PROJDATAFROMSTREAMIO)
-#endif
-      try
-        {
-          detail::checked_seekg("get_segment_by_view", *sino_stream, get_offset(bin));
-          succeeded = read_data(*sino_stream, segment, on_disk_data_type, scale, on_disk_byte_order);
-        }
-      catch (...)
-        {
-          succeeded = Succeeded::no;
-        }
-      // end of critical section
+      succeeded = this->read_from_stream([&](std::istream& s) {
+        detail::checked_seekg("get_segment_by_view", s, get_offset(bin));
+        succeeded = read_data(s, segment, on_disk_data_type, scale, on_disk_byte_order);
+        return succeeded;
+      });
       if (succeeded == Succeeded::no)
         error("ProjDataFromStream: error reading data");
       if (scale != 1)
@@ -14,7 +14,7 @@
     Copyright (C) 2002 - 2011-02-23, Hammersmith Imanet Ltd
     Copyright (C) 2011, Kris Thielemans
     Copyright (C) 2016, University of Hull
-    Copyright (C) 2016, 2019, 2020, 2023, 2024, UCL
+    Copyright (C) 2016, 2019, 2020, 2023, 2024, 2026, UCL
     Copyright (C) 2020,  Rutherford Appleton Laboratory STFC
     This file is part of STIR.
 
@@ -31,6 +31,7 @@
 #include "stir/Bin.h"
 #include "stir/is_null_ptr.h"
 #include "stir/numerics/norm.h"
+#include "stir/num_threads.h"
 #include <iostream>
 #include <cstring>
 #include <algorithm>
@@ -73,7 +74,9 @@ ProjDataInMemory::ProjDataInMemory(shared_ptr<const ExamInfo> const& exam_info_s
 void
 ProjDataInMemory::create_buffer(const bool initialise_with_0)
 {
-  this->buffer.resize(0, this->size_all() - 1, initialise_with_0);
+  // Array<1,float>::resize initialises in parallel, such that the pages are spread over the NUMA nodes.
+  // We therefore also initialise when not asked for if parallel first-touch is enabled.
+  this->buffer.resize(0, this->size_all() - 1, initialise_with_0 || get_parallel_first_touch());
 }
 
 ///////////////// /set functions
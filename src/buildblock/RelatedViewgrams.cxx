@@ -4,6 +4,7 @@
     Copyright (C) 2000 PARAPET partners
     Copyright (C) 2000 - 2007-10-08, Hammersmith Imanet Ltd
     Copyright (C) 2011-07-01 - 2011, Kris Thielemans
+    Copyright (C) 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0 AND License-ref-PARAPET-license
@@ -77,6 +78,45 @@ RelatedViewgrams<elemT>::get_empty_copy() const
   return RelatedViewgrams<elemT>(empty_viewgrams, symmetries_used);
 }
 
+template <typename elemT>
+RelatedViewgrams<elemT>::RelatedViewgrams(const shared_ptr<const ProjDataInfo>& proj_data_info_sptr,
+                                          const ViewgramIndices& basic_viewgram_indices,
+                                          const shared_ptr<DataSymmetriesForViewSegmentNumbers>& symmetries_used_v,
+                                          ArrayStoragePool<elemT>& pool)
+    : symmetries_used(symmetries_used_v)
+{
+  vector<ViewSegmentNumbers> pairs;
+  symmetries_used->get_related_view_segment_numbers(pairs, basic_viewgram_indices);
+
+  viewgrams.reserve(pairs.size());
+  const std::size_t num_tangential_poss = static_cast<std::size_t>(proj_data_info_sptr->get_num_tangential_poss());
+  for (unsigned int i = 0; i < pairs.size(); i++)
+    {
+      pairs[i].timing_pos_num() = basic_viewgram_indices.timing_pos_num();
+      const std::size_t num_elements
+          = static_cast<std::size_t>(proj_data_info_sptr->get_num_axial_poss(pairs[i].segment_num())) * num_tangential_poss;
+      viewgrams.emplace_back(proj_data_info_sptr, pairs[i], pool.get_block(num_elements));
+      viewgrams.back().fill(0);
+    }
+  check_state();
+}
+
+template <typename elemT>
+RelatedViewgrams<elemT>
+RelatedViewgrams<elemT>::get_empty_copy(ArrayStoragePool<elemT>& pool) const
+{
+  check_state();
+
+  // pooled viewgrams always have the sizes given by the ProjDataInfo
+  for (unsigned int i = 0; i < viewgrams.size(); i++)
+    if (viewgrams[i].get_num_axial_poss()
+            != viewgrams[i].get_proj_data_info_sptr()->get_num_axial_poss(viewgrams[i].get_segment_num())
+        || viewgrams[i].get_num_tangential_poss() != viewgrams[i].get_proj_data_info_sptr()->get_num_tangential_poss())
+      return get_empty_copy();
+
+  return RelatedViewgrams<elemT>(get_proj_data_info_sptr(), get_basic_viewgram_indices(), symmetries_used, pool);
+}
+
 template <typename elemT>
 bool
 RelatedViewgrams<elemT>::has_same_characteristics(self_type const& other, string& explanation) const
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 2015, University College London
+    Copyright (C) 2015, 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0
@@ -22,10 +22,16 @@
 #include "stir/warning.h"
 
 #include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
 
 #ifdef STIR_OPENMP
 #  include <omp.h>
 #endif
+#if defined(STIR_OPENMP) && defined(__linux__)
+#  include <sched.h>
+#endif
 
 START_NAMESPACE_STIR
 
@@ -90,4 +96,105 @@ set_default_num_threads()
   set_num_threads(get_default_num_threads());
 }
 
+void
+run_tasks_in_parallel_slots(const int num_tasks,
+                            const int num_slots,
+                            const std::function<void(const int task_num, const int slot_num)>& task)
+{
+#ifdef STIR_OPENMP
+  if (num_slots > 1 && num_tasks > 1)
+    {
+      const int num_threads_per_slot = std::max(1, get_max_num_threads() / num_slots);
+      const int old_max_active_levels = omp_get_max_active_levels();
+      omp_set_max_active_levels(std::max(old_max_active_levels, omp_get_active_level() + 2));
+#  pragma omp parallel for num_threads(num_slots) schedule(static, 1)
+      for (int slot_num = 0; slot_num < num_slots; ++slot_num)
+        {
+          omp_set_num_threads(num_threads_per_slot);
+          for (int task_num = slot_num; task_num < num_tasks; task_num += num_slots)
+            task(task_num, slot_num);
+        }
+      omp_set_max_active_levels(old_max_active_levels);
+      return;
+    }
+#endif
+  for (int task_num = 0; task_num < num_tasks; ++task_num)
+    task(task_num, task_num % std::max(num_slots, 1));
+}
+
+static std::atomic<bool> parallel_first_touch(true);
+
+void
+set_parallel_first_touch(const bool value)
+{
+  parallel_first_touch = value;
+}
+
+bool
+get_parallel_first_touch()
+{
+  return parallel_first_touch;
+}
+
+int
+get_num_threads_for_first_touch(const std::size_t num_bytes)
+{
+#ifdef STIR_OPENMP
+  // below this size, the overhead of starting the threads is larger than the gain
+  const std::size_t min_num_bytes_per_thread = 1024 * 1024;
+  if (!parallel_first_touch || omp_in_parallel())
+    return 1;
+  const std::size_t max_num_threads = static_cast<std::size_t>(get_max_num_threads());
+  return static_cast<int>(std::max(std::size_t(1), std::min(max_num_threads, num_bytes / min_num_bytes_per_thread)));
+#else
+  return 1;
+#endif
+}
+
+bool
+bind_threads_to_processors()
+{
+#if defined(STIR_OPENMP) && defined(__linux__)
+#  if _OPENMP >= 201307
+  if (omp_get_proc_bind() != omp_proc_bind_false)
+    {
+      info("bind_threads_to_processors: threads are already bound by the OpenMP run-time", 2);
+      return true;
+    }
+#  endif
+  cpu_set_t allowed_cpus;
+  CPU_ZERO(&allowed_cpus);
+  if (sched_getaffinity(0, sizeof(allowed_cpus), &allowed_cpus) != 0)
+    {
+      warning("bind_threads_to_processors: could not get the processors available to this process");
+      return false;
+    }
+  std::vector<int> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    if (CPU_ISSET(cpu, &allowed_cpus))
+      cpus.push_back(cpu);
+  if (cpus.empty())
+    return false;
+
+  const int num_threads = get_max_num_threads();
+  bool success = true;
+#  pragma omp parallel num_threads(num_threads) reduction(&& : success)
+  {
+    const int thread_num = omp_get_thread_num();
+    // spread the threads evenly, such that they are divided over all NUMA nodes
+    const std::size_t cpu_index = (static_cast<std::size_t>(thread_num) * cpus.size()) / num_threads;
+    cpu_set_t thread_cpus;
+    CPU_ZERO(&thread_cpus);
+    CPU_SET(cpus[cpu_index], &thread_cpus);
+    // pid 0 means the calling thread
+    success = sched_setaffinity(0, sizeof(thread_cpus), &thread_cpus) == 0;
+  }
+  if (!success)
+    warning("bind_threads_to_processors: could not bind all threads");
+  return success;
+#else
+  return false;
+#endif
+}
+
 END_NAMESPACE_STIR
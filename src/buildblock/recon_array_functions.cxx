@@ -167,6 +167,78 @@ truncate_rim(DiscretisedDensity<3, float>& input_image, const int rim_truncation
     }
 }
 
+// KT&SM&MJ 21/05/2001 changed truncation strategy
+// before singularities (non-zero divided by zero) were set to 0
+// now they are set to max_quotient
+// The old version was
+//   if(denominator<=small_value || numerator<=0.0) {
+//     if(numerator>small_value && denominator<=small_value) count++;
+//     else if( numerator<0.0) count2++;
+//     numerator=0.0;
+//   }
+//   else {
+//     //MJ 28/10/99 corrected - moved above the sinogram division
+//     if (log_likelihood_ptr != NULL)
+//       *log_likelihood_ptr -= numerator*log(denominator);
+//     numerator/=denominator;
+//   }
+static inline float
+divide_and_truncate_one_value(
+    float num, const float denom, const float small_value, int& count, int& count2, double* log_likelihood_ptr)
+{
+  if (num <= small_value) // KT Feb2011 was "num<small_value", resulting in a BUG if the whole numerator viewgram was zero
+    {
+      // we think num was really 0
+      // (we compare with small_value due to rounding errors)
+      // this case includes 0/0, but also num<0
+      num = 0;
+      if (num < 0)
+        count2++;
+    }
+  else
+    {
+      const float max_quotient = 10000.F;
+      // set quotient to min(numerator/denominator, max_quotient)
+      // a bit tricky to avoid division by 0
+      // we do this by effectively using
+      // new_denom = max(denominator[r][b], max_quotient/num)
+      // Note that this includes the case if a negative denominator
+      // (in case somebody forward projects an image with negatives)
+      if (num > max_quotient * denom)
+        {
+          // cancel singularity
+          count++;
+          if (log_likelihood_ptr != NULL)
+            *log_likelihood_ptr -= double(num * log(num / max_quotient));
+          num = max_quotient;
+        }
+      else
+        {
+          if (log_likelihood_ptr != NULL)
+            *log_likelihood_ptr -= double(num * log(denom));
+          num = num / denom;
+        }
+    }
+  return num;
+}
+
+float
+get_divide_and_truncate_threshold(const Viewgram<float>& numerator)
+{
+  return max(numerator.find_max() * SMALL_NUM, 0.F);
+}
+
+float
+divide_and_truncate(const float numerator,
+                    const float denominator,
+                    const float small_value,
+                    int& count,
+                    int& count2,
+                    double* log_likelihood_ptr /* = NULL */)
+{
+  return divide_and_truncate_one_value(numerator, denominator, small_value, count, count2, log_likelihood_ptr);
+}
+
 // AZ&KT 04/10/99: added rim_truncation_sino
 void
 divide_and_truncate(Viewgram<float>& numerator,
@@ -182,7 +254,7 @@ divide_and_truncate(Viewgram<float>& numerator,
   const int bs = numerator.get_min_tangential_pos_num();
   const int be = numerator.get_max_tangential_pos_num();
 
-  const float small_value = max(numerator.find_max() * SMALL_NUM, 0.F);
+  const float small_value = get_divide_and_truncate_threshold(numerator);
 
   double result = 0; // use this for total result for this viewgram, reducing numerical error
   for (int r = rs; r <= re; r++)
@@ -190,73 +262,19 @@ divide_and_truncate(Viewgram<float>& numerator,
       double sub_result = 0; // use this for total result for this r, reducing numerical error
       for (int b = bs; b <= be; b++)
         {
-
-          // KT&SM&MJ 21/05/2001 changed truncation strategy
-          // before singularities (non-zero divided by zero) were set to 0
-          // now they are set to max_quotient
-#if 0
-      // old version
-      if(denominator[r][b]<=small_value ||
-	 numerator[r][b]<=0.0 ||
-	 b<bs+rim_truncation_sino ||
-	 b>be-rim_truncation_sino ) {
-	if(numerator[r][b]>small_value && denominator[r][b]<=small_value) count++;
-	else if( numerator[r][b]<0.0) count2++;
-	numerator[r][b]=0.0;
-      }     
-      else {
-	//MJ 28/10/99 corrected - moved above the sinogram division
-	if (log_likelihood_ptr != NULL) {
-	      sub_result -= numerator[r][b]*log(denominator[r][b]);
-	};
-	numerator[r][b]/=denominator[r][b];
-      };
-
-#else
           if (b < bs + rim_truncation_sino || b > be - rim_truncation_sino)
             {
               numerator[r][b] = 0;
             }
           else
             {
-              float& num = numerator[r][b];
-              if (num
-                  <= small_value) // KT Feb2011 was "num<small_value", resulting in a BUG if the whole numerator viewgram was zero
-                {
-                  // we think num was really 0
-                  // (we compare with small_value due to rounding errors)
-                  // this case includes 0/0, but also num<0
-                  num = 0;
-                  if (num < 0)
-                    count2++;
-                }
-              else
-                {
-                  const float max_quotient = 10000.F;
-                  const float denom = denominator[r][b];
-                  // set quotient to min(numerator/denominator, max_quotient)
-                  // a bit tricky to avoid division by 0
-                  // we do this by effectively using
-                  // new_denom = max(denominator[r][b], max_quotient/num)
-                  // Note that this includes the case if a negative denominator
-                  // (in case somebody forward projects an image with negatives)
-                  if (num > max_quotient * denom)
-                    {
-                      // cancel singularity
-                      count++;
-                      if (log_likelihood_ptr != NULL)
-                        sub_result -= double(num * log(num / max_quotient));
-                      num = max_quotient;
-                    }
-                  else
-                    {
-                      if (log_likelihood_ptr != NULL)
-                        sub_result -= double(num * log(denom));
-                      num = num / denom;
-                    }
-                }
+              numerator[r][b] = divide_and_truncate_one_value(numerator[r][b],
+                                                              denominator[r][b],
+                                                              small_value,
+                                                              count,
+                                                              count2,
+                                                              log_likelihood_ptr != NULL ? &sub_result : NULL);
             }
-#endif
         }
       if (log_likelihood_ptr != NULL)
         result += sub_result;
@@ -4,7 +4,7 @@
     Copyright (C) 2000 PARAPET partners
     Copyright (C) 2000 - 2011-01-11, Hammersmith Imanet Ltd
     Copyright (C) 2011-07-01 - 2012, Kris Thielemans
-    Copyright (C) 2023 - 2025, University College London
+    Copyright (C) 2023 - 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0 AND License-ref-PARAPET-license
@@ -26,6 +26,7 @@
 #include "stir/assign.h"
 #include "stir/HigherPrecision.h"
 #include "stir/error.h"
+#include "stir/num_threads.h"
 
 #ifdef TESTARRAYDEBINFO
 #  include "stir/info.h"
@@ -119,9 +120,10 @@ Array<num_dimensions, elemT>::Array(const IndexRange<num_dimensions>& range)
   // DEBINFO("Array constructor range " + std::to_string(reinterpret_cast<std::size_t>(this->_allocated_full_data_ptr)) + " of
   // size "
   // + std::to_string(range.size_all())); set elements to zero
-  std::for_each(this->_allocated_full_data_ptr.get(), this->_allocated_full_data_ptr.get() + range.size_all(), [](elemT& e) {
-    assign(e, 0);
-  });
+  // (in parallel, such that the memory is spread over NUMA nodes)
+  elemT zero;
+  assign(zero, 0);
+  fill_with_first_touch(this->_allocated_full_data_ptr.get(), range.size_all(), zero);
   this->init(range, this->_allocated_full_data_ptr.get(), false);
 }
 
@@ -622,8 +624,12 @@ Array<1, elemT>::resize(const int min_index, const int max_index, bool initialis
 
   if (oldlength == 0)
     {
-      for (int i = this->get_min_index(); i <= this->get_max_index(); i++)
-        assign(this->num[i], 0);
+      if (this->size() > 0)
+        {
+          elemT zero;
+          assign(zero, 0);
+          fill_with_first_touch(&this->num[this->get_min_index()], this->size(), zero);
+        }
     }
   else
     {
@@ -0,0 +1,76 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup Array
+  \brief Declaration of class stir::ArrayStoragePool
+*/
+#ifndef __stir_ArrayStoragePool_H__
+#define __stir_ArrayStoragePool_H__
+
+#include "stir/shared_ptr.h"
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+START_NAMESPACE_STIR
+
+/*!
+  \ingroup Array
+  \brief A pool of contiguous blocks of memory, to be used as storage for Array objects
+
+  Code that constructs many temporary arrays of the same size (e.g. viewgrams in
+  distributable_computation()) spends a lot of time in the memory allocator, and can
+  suffer from contention between threads in the allocator. This class keeps blocks that are no
+  longer used, such that they can be reused for the next array of the same size.
+
+  get_block() returns a \c shared_ptr. When the last copy of the \c shared_ptr is destroyed,
+  the block is returned to the pool (or deleted when the pool has enough free blocks of that size).
+  The blocks can therefore be passed to the Array constructor that takes a \c shared_ptr
+  to existing data.
+
+  All member functions are thread-safe. However, get_thread_local_pool() should normally be used
+  such that threads do not share a pool.
+
+  \warning The data in the blocks are not initialised.
+*/
+template <typename elemT>
+class ArrayStoragePool
+{
+public:
+  //! Get a pool for the current thread
+  /*! The pool persists for the life-time of the thread (and is therefore reused across
+      OpenMP parallel regions). */
+  static inline ArrayStoragePool& get_thread_local_pool();
+
+  //! Constructor
+  /*! \param max_num_free_blocks_per_size maximum number of unused blocks that are kept for every size */
+  explicit inline ArrayStoragePool(const std::size_t max_num_free_blocks_per_size = 64);
+
+  //! Get a block of \a num_elements elements
+  inline shared_ptr<elemT[]> get_block(const std::size_t num_elements);
+
+  //! Number of unused blocks currently in the pool
+  inline std::size_t get_num_free_blocks() const;
+
+  //! Delete all unused blocks
+  inline void clear();
+
+private:
+  //! the actual pool. It is kept alive by the blocks that are in use.
+  class State;
+  shared_ptr<State> state_sptr;
+};
+
+END_NAMESPACE_STIR
+
+#include "stir/ArrayStoragePool.inl"
+
+#endif
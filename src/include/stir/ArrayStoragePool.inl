@@ -0,0 +1,116 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup Array
+  \brief Implementation of inline functions of class stir::ArrayStoragePool
+*/
+
+START_NAMESPACE_STIR
+
+template <typename elemT>
+class ArrayStoragePool<elemT>::State
+{
+public:
+  explicit State(const std::size_t max_num_free_blocks_per_size)
+      : max_num_free_blocks_per_size(max_num_free_blocks_per_size)
+  {}
+
+  ~State() { clear(); }
+
+  elemT* get(const std::size_t num_elements)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto iter = free_blocks.find(num_elements);
+      if (iter != free_blocks.end() && !iter->second.empty())
+        {
+          elemT* block = iter->second.back();
+          iter->second.pop_back();
+          return block;
+        }
+    }
+    return new elemT[num_elements];
+  }
+
+  void release(elemT* block, const std::size_t num_elements)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      std::vector<elemT*>& blocks = free_blocks[num_elements];
+      if (blocks.size() < max_num_free_blocks_per_size)
+        {
+          blocks.push_back(block);
+          return;
+        }
+    }
+    delete[] block;
+  }
+
+  std::size_t get_num_free_blocks() const
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t num_blocks = 0;
+    for (const auto& size_and_blocks : free_blocks)
+      num_blocks += size_and_blocks.second.size();
+    return num_blocks;
+  }
+
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& size_and_blocks : free_blocks)
+      for (elemT* block : size_and_blocks.second)
+        delete[] block;
+    free_blocks.clear();
+  }
+
+private:
+  const std::size_t max_num_free_blocks_per_size;
+  mutable std::mutex mutex;
+  std::map<std::size_t, std::vector<elemT*>> free_blocks;
+};
+
+template <typename elemT>
+ArrayStoragePool<elemT>&
+ArrayStoragePool<elemT>::get_thread_local_pool()
+{
+  static thread_local ArrayStoragePool<elemT> pool;
+  return pool;
+}
+
+template <typename elemT>
+ArrayStoragePool<elemT>::ArrayStoragePool(const std::size_t max_num_free_blocks_per_size)
+    : state_sptr(std::make_shared<State>(max_num_free_blocks_per_size))
+{}
+
+template <typename elemT>
+shared_ptr<elemT[]>
+ArrayStoragePool<elemT>::get_block(const std::size_t num_elements)
+{
+  shared_ptr<State> state = this->state_sptr;
+  return shared_ptr<elemT[]>(state->get(num_elements),
+                             [state, num_elements](elemT* block) { state->release(block, num_elements); });
+}
+
+template <typename elemT>
+std::size_t
+ArrayStoragePool<elemT>::get_num_free_blocks() const
+{
+  return this->state_sptr->get_num_free_blocks();
+}
+
+template <typename elemT>
+void
+ArrayStoragePool<elemT>::clear()
+{
+  this->state_sptr->clear();
+}
+
+END_NAMESPACE_STIR
@@ -0,0 +1,146 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+#ifndef __stir_IO_ChunkedDataFile_h__
+#define __stir_IO_ChunkedDataFile_h__
+/*!
+  \file
+  \ingroup IO
+  \brief Declaration of classes stir::ChunkedDataFile and stir::ChunkedDataFileWriter
+*/
+#include "stir/shared_ptr.h"
+#include "stir/Succeeded.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+START_NAMESPACE_STIR
+
+/*!
+  \ingroup IO
+  \brief Read access to a file with float data stored in independently compressed chunks
+
+  The file contains a sequence of chunks of \c float data. Each chunk is compressed on
+  its own, such that any part of the data can be read without decompressing the whole file.
+  Logically, the file therefore behaves as a (much larger) raw file with the concatenated data,
+  and offsets in that "uncompressed" data are used everywhere. This means that the file can be used as the
+  data file of an Interfile header, see read_interfile_image() and read_interfile_PDFS().
+
+  Chunks are compressed as follows:
+  - optionally, quantise the data to 16-bit integers with a scale factor per chunk (this is lossy);
+  - shuffle the bytes, i.e. first store all first bytes of the numbers, then all second bytes etc.
+    (this normally makes the data much more compressible);
+  - compress with the deflate algorithm of zlib, if STIR was built with zlib. If the
+    compressed data is not smaller, the chunk is stored uncompressed.
+
+  The file starts with a header with a signature (see has_signature()), followed by the chunks
+  and a table with the offset and size of every chunk. All numbers in the header and table
+  are stored in little endian. The data itself is in the byte order of the system that wrote it.
+
+  All member functions are thread-safe. read() decompresses the chunks in parallel when
+  STIR is built with OpenMP.
+*/
+class ChunkedDataFile
+{
+public:
+  //! Checks if the file starts with the signature of a chunked data file
+  static bool has_signature(const std::string& filename);
+
+  //! Create a stream that reads the uncompressed data from \a file_sptr
+  /*! Every stream keeps its own decompressed chunk and file position, so different
+      streams can be used by different threads. The stream cannot be used for writing.
+  */
+  static shared_ptr<std::iostream> create_stream(const shared_ptr<const ChunkedDataFile>& file_sptr);
+
+  //! Open the file and read the table of chunks. Calls error() if this fails.
+  explicit ChunkedDataFile(const std::string& filename);
+
+  //! Size (in bytes) of the uncompressed data
+  std::streamoff get_uncompressed_size() const;
+
+  std::size_t get_num_chunks() const;
+
+  //! Find the chunk that contains the byte at position \a offset in the uncompressed data
+  std::size_t find_chunk(const std::streamoff offset) const;
+
+  //! Position of the first byte of a chunk in the uncompressed data
+  std::streamoff get_chunk_start(const std::size_t chunk_num) const;
+
+  //! Decompress a single chunk
+  Succeeded read_chunk(std::vector<char>& buffer, const std::size_t chunk_num) const;
+
+  //! Copy \a length bytes of the uncompressed data, starting at \a offset, into \a buffer
+  Succeeded read(char* buffer, const std::streamoff offset, const std::streamoff length) const;
+
+private:
+  struct ChunkInfo
+  {
+    std::streamoff uncompressed_offset;
+    std::streamoff stored_offset;
+    std::streamoff stored_size;
+    std::size_t num_elements;
+    float scale;
+    bool compressed;
+  };
+
+  std::string filename;
+  int num_bytes_per_element;
+  std::vector<ChunkInfo> chunks;
+  std::streamoff uncompressed_size;
+  mutable std::ifstream file;
+};
+
+/*!
+  \ingroup IO
+  \brief Class for writing a file in the format read by ChunkedDataFile
+
+  Chunks are appended with write_chunks(). They are compressed in parallel when
+  STIR is built with OpenMP, so it is best to pass several chunks at once.
+*/
+class ChunkedDataFileWriter
+{
+public:
+  //! Open the file for writing
+  /*! \param filename name of the output file (no extension is added)
+      \param compression_level is passed to zlib (0 means no compression, 9 is maximal).
+        Higher levels are considerably slower but give only slightly smaller files for image data.
+      \param quantise_to_16_bits if \c true, data are stored as 16-bit integers (with a scale
+        factor per chunk), which is not lossless.
+  */
+  ChunkedDataFileWriter(const std::string& filename, const int compression_level = 1, const bool quantise_to_16_bits = false);
+
+  //! Calls close() if necessary
+  ~ChunkedDataFileWriter();
+
+  //! Compress and append chunks to the file
+  Succeeded write_chunks(const std::vector<std::vector<float>>& chunks);
+
+  //! Write the table with chunk information and close the file
+  Succeeded close();
+
+private:
+  std::string filename;
+  int compression_level;
+  bool quantise_to_16_bits;
+  std::ofstream file;
+  struct ChunkInfo
+  {
+    std::streamoff stored_offset;
+    std::streamoff stored_size;
+    std::size_t num_elements;
+    float scale;
+    bool compressed;
+  };
+  std::vector<ChunkInfo> chunks;
+  bool is_open;
+};
+
+END_NAMESPACE_STIR
+
+#endif
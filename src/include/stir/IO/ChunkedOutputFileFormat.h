@@ -0,0 +1,80 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup IO
+  \brief Declaration of class stir::ChunkedOutputFileFormat
+*/
+
+#ifndef __stir_IO_ChunkedOutputFileFormat_H__
+#define __stir_IO_ChunkedOutputFileFormat_H__
+
+#include "stir/IO/OutputFileFormat.h"
+#include "stir/RegisteredParsingObject.h"
+
+START_NAMESPACE_STIR
+
+template <int num_dimensions, typename elemT>
+class DiscretisedDensity;
+
+/*!
+  \ingroup IO
+  \brief
+  Implementation of OutputFileFormat paradigm for an Interfile header with a compressed data file.
+
+  The data file is a ChunkedDataFile with one chunk per image plane. The data are always
+  stored as floats (optionally quantised to 16 bits). The image can be read back as any other
+  Interfile image.
+
+  \par Parsing
+  \verbatim
+  Chunked Output File Format Parameters:=
+   ; zlib compression level (0-9)
+   compression level := 1
+   ; if 1, store data as 16-bit integers with a scale factor per plane (not lossless)
+   quantise to 16 bits := 0
+  End Chunked Output File Format Parameters:=
+  \endverbatim
+ */
+class ChunkedOutputFileFormat : public RegisteredParsingObject<ChunkedOutputFileFormat,
+                                                               OutputFileFormat<DiscretisedDensity<3, float>>,
+                                                               OutputFileFormat<DiscretisedDensity<3, float>>>
+{
+private:
+  typedef RegisteredParsingObject<ChunkedOutputFileFormat,
+                                  OutputFileFormat<DiscretisedDensity<3, float>>,
+                                  OutputFileFormat<DiscretisedDensity<3, float>>>
+      base_type;
+
+public:
+  //! Name which will be used when parsing an OutputFileFormat object
+  static const char* const registered_name;
+
+  ChunkedOutputFileFormat(const int compression_level = 1, const bool quantise_to_16_bits = false);
+
+  //! Only floats are supported
+  NumericType set_type_of_numbers(const NumericType&, const bool warn = false) override;
+  //! Only native byte order is supported
+  ByteOrder set_byte_order(const ByteOrder&, const bool warn = false) override;
+
+protected:
+  Succeeded actual_write_to_file(std::string& output_filename, const DiscretisedDensity<3, float>& density) const override;
+
+  void set_defaults() override;
+  void initialise_keymap() override;
+  bool post_processing() override;
+
+private:
+  int compression_level;
+  bool quantise_to_16_bits;
+};
+
+END_NAMESPACE_STIR
+
+#endif
@@ -0,0 +1,82 @@
+//
+//
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup projdata
+  \brief Declaration of class stir::ProjDataFromChunkedFile
+*/
+#ifndef __stir_ProjDataFromChunkedFile_H__
+#define __stir_ProjDataFromChunkedFile_H__
+
+#include "stir/ProjDataFromStream.h"
+#include <string>
+
+START_NAMESPACE_STIR
+
+class ChunkedDataFile;
+
+/*!
+  \ingroup projdata
+  \brief Read-only projection data stored in a compressed ChunkedDataFile
+
+  Files are written by write_to_file(), which stores every viewgram (for every TOF bin) in its
+  own chunk, together with an Interfile header. ProjData::read_from_file() (via read_interfile_PDFS())
+  constructs an object of this type when the data file is a ChunkedDataFile.
+
+  Reading a viewgram decompresses only its chunk. Every read uses its own stream, so
+  different threads can read at the same time. Reading a segment decompresses
+  all its chunks in parallel.
+
+  The data cannot be modified. Calling any of the \c set_ functions results in an error.
+*/
+class ProjDataFromChunkedFile : public ProjDataFromStream
+{
+public:
+  //! Write \a proj_data as an Interfile header and a ChunkedDataFile
+  /*! The header gets extension <tt>.hs</tt>, and the data file <tt>.chk</tt>.
+      See ChunkedDataFileWriter for the other parameters.
+  */
+  static Succeeded write_to_file(const std::string& filename,
+                                 const ProjData& proj_data,
+                                 const int compression_level = 1,
+                                 const bool quantise_to_16_bits = false);
+
+  //! constructor taking all necessary parameters
+  /*! See ProjDataFromStream. \a file_sptr is the chunked file with the data. The other parameters
+      are the same as for a raw file with the uncompressed data.
+  */
+  ProjDataFromChunkedFile(shared_ptr<const ExamInfo> const& exam_info_sptr,
+                          shared_ptr<const ProjDataInfo> const& proj_data_info_sptr,
+                          shared_ptr<const ChunkedDataFile> const& file_sptr,
+                          const std::streamoff offs,
+                          const std::vector<int>& segment_sequence_in_stream,
+                          StorageOrder o = Segment_View_AxialPos_TangPos,
+                          NumericType data_type = NumericType::FLOAT,
+                          ByteOrder byte_order = ByteOrder::native,
+                          float scale_factor = 1.f);
+
+  Succeeded set_viewgram(const Viewgram<float>& v) override;
+  Succeeded set_sinogram(const Sinogram<float>& s) override;
+  Succeeded set_segment(const SegmentBySinogram<float>&) override;
+  Succeeded set_segment(const SegmentByView<float>&) override;
+  void set_bin_value(const Bin& bin) override;
+
+protected:
+  //! Creates a new stream for every call, such that no locking is needed
+  Succeeded read_from_stream(const std::function<Succeeded(std::istream&)>& read_function) const override;
+
+private:
+  shared_ptr<const ChunkedDataFile> file_sptr;
+};
+
+END_NAMESPACE_STIR
+
+#endif
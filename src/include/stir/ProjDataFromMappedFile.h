@@ -0,0 +1,88 @@
+//
+//
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup projdata
+  \brief Declaration of class stir::ProjDataFromMappedFile
+*/
+#ifndef __stir_ProjDataFromMappedFile_H__
+#define __stir_ProjDataFromMappedFile_H__
+
+#include "stir/ProjDataFromStream.h"
+#include <string>
+
+START_NAMESPACE_STIR
+
+/*!
+  \ingroup projdata
+  \brief A ProjDataFromStream that reads data from a memory-mapped file
+
+  ProjDataFromStream needs to serialise all read operations, as a single \c std::iostream
+  cannot be used by several threads at the same time. When the file is opened read-only,
+  this class maps it into memory and gives every read its own (light-weight) stream over the
+  mapped data. Reading viewgrams etc from multiple threads therefore does not need any locking,
+  and there is no extra copy into the buffer of an \c fstream.
+
+  Memory mapping is only used when the file is opened without \c std::ios::out, and when
+  the system supports it (see is_supported()). Otherwise, the object behaves exactly
+  as a ProjDataFromStream.
+
+  \warning The file should not be modified by another process while it is mapped.
+*/
+class ProjDataFromMappedFile : public ProjDataFromStream
+{
+public:
+  //! Returns \c true if STIR was built with support for memory mapping
+  static bool is_supported();
+
+  //! constructor taking all necessary parameters
+  /*! \a s has to be a stream for the file \a filename, opened with \a open_mode. It is used
+      for writing, and for reading if the file is not mapped.
+
+      See ProjDataFromStream for the other parameters.
+  */
+  ProjDataFromMappedFile(shared_ptr<const ExamInfo> const& exam_info_sptr,
+                         shared_ptr<const ProjDataInfo> const& proj_data_info_sptr,
+                         shared_ptr<std::iostream> const& s,
+                         const std::string& filename,
+                         const std::ios::openmode open_mode,
+                         const std::streamoff offs,
+                         const std::vector<int>& segment_sequence_in_stream,
+                         StorageOrder o = Segment_View_AxialPos_TangPos,
+                         NumericType data_type = NumericType::FLOAT,
+                         ByteOrder byte_order = ByteOrder::native,
+                         float scale_factor = 1.f);
+
+  ~ProjDataFromMappedFile() override;
+
+  //! Returns \c true if the data are read from the mapped file
+  bool is_mapped() const;
+
+  //! Tell the operating system that a viewgram will be read soon
+  /*! This can be used to let the data be read from disk in the background, e.g.
+      for the next viewgrams in a subset. Does nothing if the file is not mapped.
+  */
+  void prefetch_viewgram(const int view_num, const int segment_num, const int timing_pos = 0) const;
+
+protected:
+  //! Passes a stream over the mapped data (without locking), or calls the base-class function if not mapped
+  Succeeded read_from_stream(const std::function<Succeeded(std::istream&)>& read_function) const override;
+
+private:
+  class Mapping;
+  shared_ptr<Mapping> mapping_sptr;
+
+  void prefetch_range(const std::streamoff start, const std::streamoff length) const;
+};
+
+END_NAMESPACE_STIR
+
+#endif
@@ -18,7 +18,7 @@
     Copyright (C) 2000 PARAPET partners
     Copyright (C) 2000- 2013, Hammersmith Imanet Ltd
     Copyright (C) 2016, University of Hull
-    Copyright (C) 2020, 2022 University College London
+    Copyright (C) 2020, 2022, 2026 University College London
 
     This file is part of STIR.
 
@@ -36,6 +36,7 @@
 #include "stir/Bin.h"
 #include <iostream>
 #include <vector>
+#include <functional>
 
 START_NAMESPACE_STIR
 
@@ -165,6 +166,15 @@ protected:
   /*! Throws if out-of-range or other error */
   std::streamoff get_offset(const Bin&) const;
 
+  //! Call \a read_function with a stream that gives access to the data
+  /*! All read operations go via this function. The default implementation passes \c sino_stream,
+      inside a critical section as a stream cannot be used by multiple threads at the same time.
+      Derived classes can override this to provide a stream that does not need locking.
+
+      Exceptions thrown by \a read_function are caught and result in Succeeded::no.
+  */
+  virtual Succeeded read_from_stream(const std::function<Succeeded(std::istream&)>& read_function) const;
+
 private:
   void activate_TOF();
   //! offset of the whole 3d sinogram in the stream
@@ -1,6 +1,7 @@
 /*
     Copyright (C) 2000 PARAPET partners
     Copyright (C) 2000-2012, Hammersmith Imanet Ltd
+    Copyright (C) 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0 AND License-ref-PARAPET-license
@@ -22,6 +23,7 @@
 
 #include "stir/Viewgram.h"
 #include "stir/DataSymmetriesForViewSegmentNumbers.h"
+#include "stir/ArrayStoragePool.h"
 #include <vector>
 
 #include <iterator>
@@ -71,6 +73,21 @@ public:
   inline RelatedViewgrams(const std::vector<Viewgram<elemT>>& viewgrams,
                           const shared_ptr<DataSymmetriesForViewSegmentNumbers>& symmetries_used);
 
+  //! a constructor which moves the viewgrams into the object
+  /*! This avoids copying the data, such that viewgrams that use existing storage keep using it. */
+  inline RelatedViewgrams(std::vector<Viewgram<elemT>>&& viewgrams,
+                          const shared_ptr<DataSymmetriesForViewSegmentNumbers>& symmetries_used);
+
+  //! construct related viewgrams with storage from a pool, data are set to 0
+  /*! This is equivalent to ProjDataInfo::get_empty_related_viewgrams(), but the data of every viewgram
+      is a block from \a pool. The blocks are returned to the pool when the object is destroyed
+      (unless a viewgram is resized), such that they can be reused.
+  */
+  RelatedViewgrams(const shared_ptr<const ProjDataInfo>& proj_data_info_sptr,
+                   const ViewgramIndices& basic_viewgram_indices,
+                   const shared_ptr<DataSymmetriesForViewSegmentNumbers>& symmetries_used,
+                   ArrayStoragePool<elemT>& pool);
+
   // --- const members returning info ---
 
   //! get 'basic' view_num
@@ -158,6 +175,9 @@ public:
   //! Return a new object with ProjDataInfo etc., but all data elements set to 0
   RelatedViewgrams get_empty_copy() const;
 
+  //! Return a new object with ProjDataInfo etc., but all data elements set to 0, using storage from a pool
+  RelatedViewgrams get_empty_copy(ArrayStoragePool<elemT>& pool) const;
+
   //! \name Equality
   //@{
   //! Checks if the 2 objects have the proj_data_info, segment_num etc.
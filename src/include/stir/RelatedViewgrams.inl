@@ -14,6 +14,7 @@
 /*
     Copyright (C) 2000 PARAPET partners
     Copyright (C) 2000-2005, Hammersmith Imanet Ltd
+    Copyright (C) 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0 AND License-ref-PARAPET-license
@@ -39,6 +40,15 @@ RelatedViewgrams<elemT>::RelatedViewgrams(const std::vector<Viewgram<elemT>>& vi
   check_state();
 }
 
+template <typename elemT>
+RelatedViewgrams<elemT>::RelatedViewgrams(std::vector<Viewgram<elemT>>&& viewgrams,
+                                          const shared_ptr<DataSymmetriesForViewSegmentNumbers>& symmetries_used)
+    : viewgrams(std::move(viewgrams)),
+      symmetries_used(symmetries_used)
+{
+  check_state();
+}
+
 template <typename elemT>
 void
 RelatedViewgrams<elemT>::check_state() const
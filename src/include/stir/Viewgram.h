@@ -4,7 +4,7 @@
     Copyright (C) 2000 PARAPET partners
     Copyright (C) 2000 - 2007-10-08, Hammersmith Imanet Ltd
     Copyright (C) 2011-07-01 - 2012, Kris Thielemans
-    Copyright (C) 2023, University College London
+    Copyright (C) 2023, 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0 AND License-ref-PARAPET-license
@@ -63,6 +63,15 @@ public:
                   const shared_ptr<const ProjDataInfo>& proj_data_info_sptr,
                   const ViewgramIndices& ind);
 
+  //! Construct from proj_data_info pointer and indices, using existing storage
+  /*!  data_sptr has to point to a contiguous block of get_num_axial_poss()*get_num_tangential_poss() elements.
+      The viewgram will use this block (as long as it is not resized), see the corresponding Array constructor.
+      Data are not initialised.
+  */
+  inline Viewgram(const shared_ptr<const ProjDataInfo>& proj_data_info_ptr,
+                  const ViewgramIndices& ind,
+                  shared_ptr<elemT[]> data_sptr);
+
   //! Construct from proj_data_info pointer, view and segment number. Data are set to 0.
   /*!
     \deprecated Use version with ViewgramIndices instead
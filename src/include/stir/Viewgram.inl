@@ -16,7 +16,7 @@
 /*
     Copyright (C) 2000 PARAPET partners
     Copyright (C) 2000- 2009, Hammersmith Imanet Ltd
-    Copyright (C) 2023, University College London
+    Copyright (C) 2023, 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0 AND License-ref-PARAPET-license
@@ -143,6 +143,20 @@ Viewgram<elemT>::Viewgram(const shared_ptr<const ProjDataInfo>& pdi_sptr, const
   // segment_num is already checked by doing get_max_axial_pos_num(s_num)
 }
 
+template <typename elemT>
+Viewgram<elemT>::Viewgram(const shared_ptr<const ProjDataInfo>& pdi_sptr, const ViewgramIndices& ind, shared_ptr<elemT[]> data_sptr)
+    : Array<2, elemT>(IndexRange2D(pdi_sptr->get_min_axial_pos_num(ind.segment_num()),
+                                   pdi_sptr->get_max_axial_pos_num(ind.segment_num()),
+                                   pdi_sptr->get_min_tangential_pos_num(),
+                                   pdi_sptr->get_max_tangential_pos_num()),
+                      data_sptr),
+      proj_data_info_sptr(pdi_sptr),
+      _indices(ind)
+{
+  assert(ind.view_num() <= proj_data_info_sptr->get_max_view_num());
+  assert(ind.view_num() >= proj_data_info_sptr->get_min_view_num());
+}
+
 template <typename elemT>
 Viewgram<elemT>::Viewgram(
     const Array<2, elemT>& p, const shared_ptr<const ProjDataInfo>& pdi_sptr, const int v_num, const int s_num, const int t_num)
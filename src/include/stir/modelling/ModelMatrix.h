@@ -94,6 +94,13 @@ public:
   */
   inline void multiply_dynamic_image_with_model(ParametricVoxelsOnCartesianGrid& parametric_image,
                                                 const DynamicDiscretisedDensity& dynamic_image) const;
+  //! multiply (transpose) model-matrix with a single frame of a dynamic image and add result to \c parametric_image
+  /*! This computes the contribution of frame \a frame_num to multiply_dynamic_image_with_model_and_add_to_input().
+    It allows accumulating frames one at a time, such that the whole dynamic image does not need to be stored.
+  */
+  inline void multiply_frame_image_with_model_and_add_to_input(ParametricVoxelsOnCartesianGrid& parametric_image,
+                                                               const DiscretisedDensity<3, float>& frame_image,
+                                                               const unsigned int frame_num) const;
   //! multiply model-matrix with parametric image and add result to original \c dynamic_image
   inline void
   multiply_parametric_image_with_model_and_add_to_input(DynamicDiscretisedDensity& dynamic_image,
@@ -286,6 +286,38 @@ ModelMatrix<num_param>::multiply_dynamic_image_with_model(ParametricVoxelsOnCart
   this->multiply_dynamic_image_with_model_and_add_to_input(parametric_image, dynamic_image);
 }
 
+template <int num_param>
+void
+ModelMatrix<num_param>::multiply_frame_image_with_model_and_add_to_input(ParametricVoxelsOnCartesianGrid& parametric_image,
+                                                                         const DiscretisedDensity<3, float>& frame_image,
+                                                                         const unsigned int frame_num) const
+{
+  BasicCoordinate<2, int> model_array_min, model_array_max;
+  if (!this->_model_array.get_regular_range(model_array_min, model_array_max))
+    error("Model array has not regular range");
+  if (static_cast<int>(frame_num) < model_array_min[2] || static_cast<int>(frame_num) > model_array_max[2])
+    error("ModelMatrix: frame number out of range of the model array");
+
+  assert(frame_image.size_all() == parametric_image.size_all());
+  assert(model_array_max[1] - model_array_min[1] + 1 == num_param);
+
+  const int min_k_index = frame_image.get_min_index();
+  const int max_k_index = frame_image.get_max_index();
+  for (int k = min_k_index; k <= max_k_index; ++k)
+    {
+      const int min_j_index = frame_image[k].get_min_index();
+      const int max_j_index = frame_image[k].get_max_index();
+      for (int j = min_j_index; j <= max_j_index; ++j)
+        {
+          const int min_i_index = frame_image[k][j].get_min_index();
+          const int max_i_index = frame_image[k][j].get_max_index();
+          for (int i = min_i_index; i <= max_i_index; ++i)
+            for (int param_num = model_array_min[1]; param_num <= model_array_max[1]; ++param_num)
+              parametric_image[k][j][i][param_num] += this->_model_array[param_num][frame_num] * frame_image[k][j][i];
+        }
+    }
+}
+
 template <int num_param>
 void
 ModelMatrix<num_param>::multiply_parametric_image_with_model_and_add_to_input(
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 2015, University College London
+    Copyright (C) 2015, 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0
@@ -20,6 +20,8 @@
 #define __stir_num_threads_h__
 
 #include "stir/common.h"
+#include <cstddef>
+#include <functional>
 
 START_NAMESPACE_STIR
 
@@ -67,6 +69,79 @@ int get_default_num_threads();
 */
 void set_default_num_threads();
 
+//! Run tasks in a number of "slots" that are processed concurrently
+/*! \ingroup threads
+  Calls \a task(task_num, slot_num) for every \c task_num in [0, \a num_tasks). Task \c task_num
+  is always run in slot <code>task_num % num_slots</code>, and the tasks in one slot are run
+  sequentially. The caller can therefore give every slot its own resources that are not
+  thread-safe (e.g. projectors).
+
+  When compiled with OpenMP and \a num_slots is larger than 1, the slots are run in parallel.
+  The available threads are divided over the slots, and nested parallelism is enabled,
+  such that \a task can still use OpenMP itself.
+
+  \warning \a task should not throw, as exceptions cannot propagate out of an OpenMP region.
+*/
+void run_tasks_in_parallel_slots(const int num_tasks,
+                                 const int num_slots,
+                                 const std::function<void(const int task_num, const int slot_num)>& task);
+
+//! Bind the OpenMP threads to the processors
+/*! \ingroup threads
+  Binds every thread of the OpenMP thread pool to one processor (out of the processors that the
+  process is allowed to use), spreading the threads evenly over the processors. This prevents the
+  operating system from moving threads to another NUMA node, away from the memory they initialised
+  (see fill_with_first_touch()).
+
+  This has to be called after set_num_threads(), as it binds get_max_num_threads() threads.
+  Nothing is done if the OpenMP run-time already binds threads (e.g. via the \c OMP_PROC_BIND
+  environment variable), which is the recommended way if you can set the environment.
+
+  \return \c true if the threads are bound. Binding is currently only supported on Linux
+  and when compiled with OpenMP support.
+*/
+bool bind_threads_to_processors();
+
+//! Enable or disable parallel initialisation of large arrays
+/*! \ingroup threads
+  Enabled by default. \see fill_with_first_touch()
+*/
+void set_parallel_first_touch(const bool value);
+
+//! Check if parallel initialisation of large arrays is enabled
+/*! \ingroup threads */
+bool get_parallel_first_touch();
+
+//! Get the number of threads to be used to initialise a block of memory
+/*! \ingroup threads
+  Returns 1 if parallel first-touch is disabled, if the block is small, or if we are already
+  in a parallel region. Otherwise returns get_max_num_threads().
+*/
+int get_num_threads_for_first_touch(const std::size_t num_bytes);
+
+//! Set elements of a contiguous block of memory to a value, using all threads
+/*! \ingroup threads
+  On NUMA systems, a memory page is normally placed on the node of the thread that writes to it first
+  (the "first touch"). If a large array is initialised by a single thread, all its data end up on one node,
+  and threads running on the other nodes have to access it via the (slower) interconnect.
+
+  This function initialises the block with a static partitioning over the threads. Loops
+  that use a static schedule over the same (outer) index therefore find their data on their own node, while
+  loops with a dynamic schedule (such as in distributable_computation()) still have the data spread over all nodes.
+*/
+template <class elemT>
+inline void
+fill_with_first_touch(elemT* const data_ptr, const std::size_t size, const elemT& value)
+{
+  const std::ptrdiff_t signed_size = static_cast<std::ptrdiff_t>(size);
+#ifdef STIR_OPENMP
+  const int num_threads = get_num_threads_for_first_touch(size * sizeof(elemT));
+#  pragma omp parallel for schedule(static) num_threads(num_threads) if (num_threads > 1)
+#endif
+  for (std::ptrdiff_t i = 0; i < signed_size; ++i)
+    data_ptr[i] = value;
+}
+
 END_NAMESPACE_STIR
 
 #endif
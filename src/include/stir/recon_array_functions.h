@@ -84,6 +84,19 @@ void divide_and_truncate(RelatedViewgrams<float>& numerator,
                          int& count2,
                          double* f = NULL);
 
+//! find the threshold below which divide_and_truncate() considers values in the numerator to be zero
+float get_divide_and_truncate_threshold(const Viewgram<float>& numerator);
+
+//! divide a single value in the same way as divide_and_truncate() does for every (non-edge) bin
+/*! \a small_value has to be found with get_divide_and_truncate_threshold() for the viewgram
+    that contains \a numerator. If \a f is not null, the contribution of this bin to the
+    log-likelihood is subtracted from \c *f.
+
+    \return the quotient
+*/
+float divide_and_truncate(
+    const float numerator, const float denominator, const float small_value, int& count, int& count2, double* f = NULL);
+
 //! sets to zero voxels within rim_truncation_image of the FOV rim
 void truncate_rim(DiscretisedDensity<3, float>& image_input,
                   const int rim_truncation_image,
@@ -15,7 +15,7 @@
 /*
     Copyright (C) 2000 PARAPET partners
     Copyright (C) 2000- 2011, Hammersmith Imanet Ltd
-    Copyright (C) 2018-2019, University College London
+    Copyright (C) 2018-2019, 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0 AND License-ref-PARAPET-license
@@ -202,6 +202,12 @@ protected:
   //! ProjDataInfo set by set_up()
   shared_ptr<const ProjDataInfo> _proj_data_info_sptr;
 
+  //! Get the image in which the current thread accumulates its back projections
+  /*! When using OpenMP, this is a thread-local image (which will be created if necessary). Otherwise it is
+      the image set by start_accumulating_in_new_target().
+  */
+  DiscretisedDensity<3, float>& get_target_for_current_thread();
+
 private:
 #ifdef STIR_OPENMP
   //! A vector of back projected images that will be used with openMP. There will be as many images as openMP threads
@@ -16,6 +16,7 @@
 /*
     Copyright (C) 2000 PARAPET partners
     Copyright (C) 2000- 2009, Hammersmith Imanet Ltd
+    Copyright (C) 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0 AND License-ref-PARAPET-license
@@ -27,6 +28,7 @@
 #include "stir/recon_buildblock/BackProjectorByBin.h"
 #include "stir/RegisteredParsingObject.h"
 #include "stir/shared_ptr.h"
+#include <functional>
 //#include "stir/DataSymmetriesForBins.h"
 //#include "stir/RelatedViewgrams.h"
 
@@ -37,6 +39,8 @@ class ProjDataInfoCylindricalArcCorr;
 
 START_NAMESPACE_STIR
 
+class ForwardProjectorByBinUsingProjMatrixByBin;
+
 /*!
   \brief This implements the BackProjectorByBin interface, given any
 ProjMatrixByBin object
@@ -71,6 +75,28 @@ public:
 
   shared_ptr<ProjMatrixByBin>& get_proj_matrix_sptr() { return proj_matrix_ptr; }
 
+  //! type of the function used by forward_project_transform_and_back_project()
+  /*! The arguments are the index of the viewgram in the RelatedViewgrams object and the bin,
+      with its value set to the forward projection. The function returns the value to back project.
+  */
+  typedef std::function<float(int viewgram_index, const Bin& bin)> BinTransformType;
+
+  //! Forward project, transform and back project related viewgrams in one pass over the bins
+  /*! This is equivalent to calling \c forward_projector.forward_project(viewgrams), replacing every bin value
+      by \c bin_transform(viewgram_index,bin) and calling back_project(viewgrams). However, the
+      row of the projection matrix is only computed once for every bin, and used for the forward and back projection
+      while it is still in cache. The forward projected viewgrams are never stored. On return,
+      \a viewgrams contains the values that have been back projected.
+
+      As for back_project(), the result is added to the data backprojected since
+      start_accumulating_in_new_target() was last called.
+
+      \a forward_projector has to use the same projection matrix as this object, and set_input() has to be called on it.
+  */
+  void forward_project_transform_and_back_project(const ForwardProjectorByBinUsingProjMatrixByBin& forward_projector,
+                                                  RelatedViewgrams<float>& viewgrams,
+                                                  const BinTransformType& bin_transform);
+
   BackProjectorByBinUsingProjMatrixByBin* clone() const override;
 
 protected:
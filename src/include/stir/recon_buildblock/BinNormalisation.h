@@ -2,7 +2,7 @@
 //
 /*
     Copyright (C) 2000- 2011, Hammersmith Imanet Ltd
-    Copyright (C) 2014, 2021, 2024, University College London
+    Copyright (C) 2014, 2021, 2024, 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0
@@ -30,6 +30,8 @@ START_NAMESPACE_STIR
 
 template <typename elemT>
 class RelatedViewgrams;
+template <typename elemT>
+class Viewgram;
 class Succeeded;
 class ProjDataInfo;
 class ProjData;
@@ -73,6 +75,13 @@ public:
   */
   virtual inline bool is_TOF_only_norm() const { return false; }
 
+  //! returns if apply() and undo() for RelatedViewgrams can be called by several threads at the same time
+  /*!
+    Callers such as distributable_computation() serialise these calls otherwise.
+    The base-class returns \c false. It is up to the derived class to change this.
+  */
+  virtual inline bool is_thread_safe() const { return false; }
+
   //! initialises the object and checks if it can handle such projection data
   /*! Default version sets _already_set_up and stores the shared pointers. */
   virtual Succeeded set_up(const shared_ptr<const ExamInfo>& exam_info_sptr, const shared_ptr<const ProjDataInfo>&);
@@ -85,13 +94,27 @@ public:
   */
   virtual float get_bin_efficiency(const Bin& bin) const = 0;
 
+  //! Return the 'efficiency' factors for all bins in a viewgram
+  /*!
+    On input, \a efficiencies determines the bins (i.e. segment, view and TOF bin, and the axial
+    and tangential ranges). On output, it contains the factors \f$\mathrm{norm}_b \f$ for these bins.
+
+    Default implementation calls get_bin_efficiency() for every bin. Derived classes
+    can provide a faster implementation.
+  */
+  virtual void fill_bin_efficiencies(Viewgram<float>& efficiencies) const;
+
+  //! Return the 'efficiency' factors for all bins in related viewgrams
+  /*! Calls fill_bin_efficiencies(Viewgram<float>&) for every viewgram */
+  void fill_bin_efficiencies(RelatedViewgrams<float>& efficiencies) const;
+
   //! normalise some data
   /*!
     This would be used for instance to precorrect unnormalised data. With the
     notation of the class documentation, this would \c divide by the factors
     \f$\mathrm{norm}_b \f$.
 
-    Default implementation divides with the factors returned by get_bin_efficiency()
+    Default implementation divides with the factors returned by fill_bin_efficiencies()
     (after applying a threshold to avoid division by 0).
   */
   virtual void apply(RelatedViewgrams<float>&) const;
@@ -103,7 +126,7 @@ public:
     notation of the class documentation, this would \c multiply by the factors
     \f$\mathrm{norm}_b \f$.
 
-    Default implementation multiplies with the factors returned by get_bin_efficiency().
+    Default implementation multiplies with the factors returned by fill_bin_efficiencies().
   */
   virtual void undo(RelatedViewgrams<float>&) const;
 
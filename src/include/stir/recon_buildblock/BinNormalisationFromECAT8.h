@@ -1,6 +1,6 @@
 /*
   Copyright (C) 2000-2007, Hammersmith Imanet Ltd
-  Copyright (C) 2013-2014, 2020, 2023 University College London
+  Copyright (C) 2013-2014, 2020, 2023, 2026 University College London
 
   Largely a copy of the ECAT7 version.
 
@@ -107,6 +107,10 @@ public:
 
   Succeeded set_up(const shared_ptr<const ExamInfo>& exam_info_sptr, const shared_ptr<const ProjDataInfo>&) override;
   float get_uncalibrated_bin_efficiency(const Bin& bin) const override;
+  //! Computes the factors for a whole viewgram
+  /*! Gives the same result as get_uncalibrated_bin_efficiency(), but the detector numbers are
+      only computed once for all axial positions. */
+  void fill_uncalibrated_bin_efficiencies(Viewgram<float>& efficiencies) const override;
 
   bool use_detector_efficiencies() const;
   bool use_dead_time() const;
@@ -10,7 +10,7 @@
 */
 /*
     Copyright (C) 2000- 2011, Hammersmith Imanet Ltd
-    Copyright (C) 2023, University College London
+    Copyright (C) 2023, 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0
@@ -82,6 +82,9 @@ public:
   */
   virtual bool is_TOF_only_norm() const override;
 
+  //! Returns \c true, as reading from ProjData is thread-safe
+  bool is_thread_safe() const override;
+
   //! Checks if we can handle certain projection data.
   /*! Compares the  ProjDataInfo from the ProjData object containing the normalisation factors
       with the ProjDataInfo supplied. */
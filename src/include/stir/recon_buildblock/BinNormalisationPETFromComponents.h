@@ -9,7 +9,7 @@
   \author Kris Thielemans
 */
 /*
-    Copyright (C) 2022, University College London
+    Copyright (C) 2022, 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0
@@ -116,6 +116,10 @@ public:
 
   float get_bin_efficiency(const Bin& bin) const override;
 
+  using base_type::fill_bin_efficiencies;
+  //! Copies the efficiencies for a whole viewgram from the stored efficiency model
+  void fill_bin_efficiencies(Viewgram<float>& efficiencies) const override;
+
 #if 0
   //! Get a shared_ptr to the normalisation proj_data.
   virtual shared_ptr<ProjData> get_norm_proj_data_sptr() const;
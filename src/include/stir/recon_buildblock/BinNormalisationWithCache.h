@@ -0,0 +1,154 @@
+//
+//
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup normalisation
+
+  \brief Declaration of class stir::BinNormalisationWithCache
+*/
+
+#ifndef __stir_recon_buildblock_BinNormalisationWithCache_H__
+#define __stir_recon_buildblock_BinNormalisationWithCache_H__
+
+#include "stir/recon_buildblock/BinNormalisation.h"
+#include "stir/RegisteredParsingObject.h"
+#include <string>
+
+START_NAMESPACE_STIR
+
+/*!
+  \ingroup normalisation
+  \brief A BinNormalisation class that computes the factors of another BinNormalisation
+  object once, and then reads them from memory or from file.
+
+  Many normalisation classes compute their factors on the fly, for instance from the
+  efficiencies of every detector (e.g. BinNormalisationFromECAT8, BinNormalisationPETFromComponents)
+  or by forward projecting an attenuation image (BinNormalisationFromAttenuationImage).
+  In an iterative reconstruction, the same factors are then recomputed for every (sub)iteration.
+  This class computes them for all bins during set_up(), after which apply() and undo() only
+  need to divide or multiply with the stored factors. These functions are therefore thread-safe,
+  see is_thread_safe().
+
+  The factors are stored in memory, unless a cache filename is set. In that case, they are written to
+  an Interfile file, which is then opened read-only with ProjData::read_from_file(). This means that the file will be
+  memory-mapped when the system supports it (see ProjDataFromMappedFile).
+
+  If the cached normalisation is not TOF-specific (see BinNormalisation::is_TOF_only_norm()),
+  the factors are stored only for non-TOF data, and used for all TOF bins.
+
+  Calling set_up() again with the same projection data info reuses the stored factors.
+
+  \par Parsing details
+  \verbatim
+  Bin Normalisation With Cache Parameters:=
+  ; type of the bin normalisation to cache, followed by its parameters
+  Bin Normalisation to cache := <ASCII>
+  ; optional file to store the factors (default is to keep them in memory)
+  cache filename :=
+  END Bin Normalisation With Cache Parameters :=
+  \endverbatim
+  \par Example
+  This caches normalisation and attenuation factors (see ChainedBinNormalisation for the
+  other parameters).
+  \verbatim
+  Bin Normalisation type := With Cache
+  Bin Normalisation With Cache Parameters:=
+    Bin Normalisation to cache := Chained
+      Chained Bin Normalisation Parameters:=
+        ...
+      END Chained Bin Normalisation Parameters :=
+  END Bin Normalisation With Cache Parameters :=
+  \endverbatim
+*/
+class BinNormalisationWithCache : public RegisteredParsingObject<BinNormalisationWithCache, BinNormalisation>
+{
+private:
+  using base_type = BinNormalisation;
+
+public:
+  //! Name which will be used when parsing a BinNormalisation object
+  static const char* const registered_name;
+
+  //! Default constructor
+  /*!
+    \warning You should not call any member functions for any object just
+    constructed with this constructor. Initialise the object properly first
+    by parsing.
+  */
+  BinNormalisationWithCache();
+
+  //! Constructor taking the normalisation to cache
+  /*! If \a cache_filename is empty, the factors are stored in memory. */
+  explicit BinNormalisationWithCache(shared_ptr<BinNormalisation> const& norm_to_cache_sptr,
+                                     const std::string& cache_filename = "");
+
+  //! Sets up the cached normalisation and computes the factors (if not done already)
+  Succeeded set_up(const shared_ptr<const ExamInfo>& exam_info_sptr, const shared_ptr<const ProjDataInfo>&) override;
+
+  // import all apply/undo methods from base-class (we'll override some below)
+  using base_type::apply;
+  using base_type::undo;
+
+  //! Normalise some data
+  /*! Divides by the stored factors (after applying a threshold to avoid division by 0) */
+  void apply(RelatedViewgrams<float>& viewgrams) const override;
+
+  //! Undo the normalisation of some data
+  /*! Multiplies with the stored factors */
+  void undo(RelatedViewgrams<float>& viewgrams) const override;
+
+  //! Returns the factor of the cached normalisation object
+  float get_bin_efficiency(const Bin& bin) const override;
+
+  using base_type::fill_bin_efficiencies;
+  //! Copies the stored factors for a whole viewgram
+  void fill_bin_efficiencies(Viewgram<float>& efficiencies) const override;
+
+  float get_calibration_factor() const override;
+
+  //! Returns the is_trivial() status of the cached normalisation object
+  bool is_trivial() const override;
+
+  //! Returns the is_TOF_only_norm() status of the cached normalisation object
+  bool is_TOF_only_norm() const override;
+
+  //! Returns \c true, as apply() and undo() only read the stored factors
+  bool is_thread_safe() const override;
+
+  shared_ptr<BinNormalisation> get_norm_to_cache_sptr() const;
+
+  //! Get the stored factors (only valid after set_up())
+  shared_ptr<const ProjData> get_factors_sptr() const;
+
+private:
+  shared_ptr<BinNormalisation> norm_to_cache_sptr;
+  std::string cache_filename;
+
+  shared_ptr<ProjData> factors_sptr;
+  //! projection data info and exam info for which the factors were computed
+  shared_ptr<const ProjDataInfo> cached_proj_data_info_sptr;
+  shared_ptr<const ExamInfo> cached_exam_info_sptr;
+
+  void compute_factors(const shared_ptr<const ExamInfo>& exam_info_sptr,
+                       const shared_ptr<const ProjDataInfo>& factors_proj_data_info_sptr);
+
+  //! read the stored factors for the same bins as \a viewgrams
+  RelatedViewgrams<float> get_factors(const RelatedViewgrams<float>& viewgrams) const;
+
+  // parsing stuff
+  void set_defaults() override;
+  void initialise_keymap() override;
+  bool post_processing() override;
+};
+
+END_NAMESPACE_STIR
+
+#endif
@@ -1,7 +1,7 @@
 //
 //
 /*
-    Copyright (C) 2020-2021, University College London
+    Copyright (C) 2020-2021, 2026, University College London
     Copyright (C) 2020, National Physical Laboratory
     This file is part of STIR.
 
@@ -68,6 +68,15 @@ public:
     return this->get_uncalibrated_bin_efficiency(bin) / this->_calib_decay_branching_ratio;
   }
 
+  //! fill efficiencies for all bins of a viewgram, without calibration
+  /*! Default implementation calls get_uncalibrated_bin_efficiency() for every bin. */
+  virtual void fill_uncalibrated_bin_efficiencies(Viewgram<float>& efficiencies) const;
+
+  using base_type::fill_bin_efficiencies;
+  //! fill efficiencies for all bins of a viewgram
+  /*! calls fill_uncalibrated_bin_efficiencies() and divides by get_calib_decay_branching_ratio_factor() */
+  void fill_bin_efficiencies(Viewgram<float>& efficiencies) const final;
+
 protected:
   // parsing stuff
   void set_defaults() override;
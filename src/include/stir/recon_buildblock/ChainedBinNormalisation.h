@@ -10,6 +10,7 @@
 */
 /*
     Copyright (C) 2003- 2005, Hammersmith Imanet Ltd
+    Copyright (C) 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0
@@ -130,6 +131,10 @@ public:
 
   float get_bin_efficiency(const Bin& bin) const override;
 
+  using base_type::fill_bin_efficiencies;
+  //! Multiplies the efficiencies of the 2 BinNormalisation members
+  void fill_bin_efficiencies(Viewgram<float>& efficiencies) const override;
+
   //! Returns the is_trivial() status of the first normalisation object.
   //! \warning Currently, if the object has not been set the function throws an error.
   virtual bool is_first_trivial() const;
@@ -143,6 +148,9 @@ public:
   */
   virtual bool is_TOF_only_norm() const override;
 
+  //! Returns \c true if both normalisation objects are thread-safe
+  bool is_thread_safe() const override;
+
   virtual shared_ptr<BinNormalisation> get_first_norm() const;
 
   virtual shared_ptr<BinNormalisation> get_second_norm() const;
@@ -19,6 +19,7 @@
 /*
     Copyright (C) 2000 PARAPET partners
     Copyright (C) 2000- 2009, Hammersmith Imanet Ltd
+    Copyright (C) 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0 AND License-ref-PARAPET-license
@@ -64,7 +65,12 @@ public:
 
   const DataSymmetriesForViewSegmentNumbers* get_symmetries_used() const override;
 
+  const shared_ptr<ProjMatrixByBin>& get_proj_matrix_sptr() const { return proj_matrix_ptr; }
+
 private:
+  // needs access to the input image for forward_project_transform_and_back_project()
+  friend class BackProjectorByBinUsingProjMatrixByBin;
+
   shared_ptr<ProjMatrixByBin> proj_matrix_ptr;
 
   void actual_forward_project(RelatedViewgrams<float>&,
@@ -32,6 +32,8 @@
 #include "stir/modelling/ParametricDiscretisedDensity.h"
 #include "stir/modelling/KineticParameters.h"
 #include "stir/modelling/PatlakPlot.h"
+#include <functional>
+#include <vector>
 
 START_NAMESPACE_STIR
 
@@ -43,6 +45,28 @@ START_NAMESPACE_STIR
 
   \par Parameters for parsing
 
+  \verbatim
+  PoissonLogLikelihoodWithLinearKineticModelAndDynamicProjectionData Parameters:=
+  ; keywords as for PoissonLogLikelihoodWithLinearModelForMeanAndProjData, and
+  ; number of frames that are evaluated concurrently (default 1, i.e. sequentially)
+  number of frames to process in parallel := 1
+  ; upper limit (in MB) on the estimated memory used by the concurrent frames
+  ; (default 0, i.e. no limit)
+  maximum memory in MB for parallel frames := 0
+  End PoissonLogLikelihoodWithLinearKineticModelAndDynamicProjectionData Parameters:=
+  \endverbatim
+
+  \par Frame-parallel evaluation
+  When more than 1 frame is processed in parallel, every concurrent "slot" gets its own
+  copy of the projector pair (constructed from its parameter_info()), such that the
+  state of the projectors is never shared between threads. The available OpenMP threads
+  are then divided over the slots, and the remainder are used by
+  distributable_computation() for each frame. The number of slots is reduced if the
+  estimated memory usage (images used by the projectors and for the per-frame gradient)
+  exceeds the specified maximum.
+
+  The gradient of every frame is multiplied with the model gradient as soon as it is
+  computed, such that the full dynamic gradient image is never stored.
 */
 
 template <typename TargetT>
@@ -58,6 +82,16 @@ private:
       base_type;
   typedef PoissonLogLikelihoodWithLinearModelForMeanAndProjData<DiscretisedDensity<3, float>> SingleFrameObjFunc;
   VectorWithOffset<SingleFrameObjFunc> _single_frame_obj_funcs;
+  //! projector pairs used by the concurrent frame slots (only used when processing frames in parallel)
+  std::vector<shared_ptr<ProjectorByBinPair>> _frame_slot_projector_pair_sptrs;
+  //! number of frame slots that are actually used (determined in set_up())
+  int _num_frame_slots;
+
+  //! Calls \a frame_task for every frame, using the frame slots for concurrent evaluation
+  /*! Frame \c starting_frame+i is always processed in slot <code>i % _num_frame_slots</code>,
+     i.e. by the projector pair in \c _frame_slot_projector_pair_sptrs with that index.
+  */
+  void process_frames(const std::function<void(const unsigned int frame_num)>& frame_task) const;
 
 public:
   //! Name which will be used when parsing a GeneralisedObjectiveFunction object
@@ -153,6 +187,10 @@ protected:
   shared_ptr<ProjectorByBinPair> _projector_pair_ptr;
   //! signals whether to zero the data in the end planes of the projection data
   bool _zero_seg0_end_planes;
+  //! maximum number of frames that are processed concurrently
+  int _num_frames_to_process_in_parallel;
+  //! maximum memory (in MB) that can be used by the concurrent frames (0 means no limit)
+  double _max_memory_in_MB_for_parallel_frames;
   // Patlak Plot Parameters
   /*! the patlak plot pointer where all the parameters are stored */
   shared_ptr<PatlakPlot> _patlak_plot_sptr;
@@ -31,6 +31,7 @@
 #include "stir/warning.h"
 #include "stir/error.h"
 #include "stir/format.h"
+#include "stir/num_threads.h"
 
 // include the following to set defaults
 #ifndef USE_PMRT
@@ -46,6 +47,7 @@
 
 #include <algorithm>
 #include <string>
+#include <sstream>
 // For the Patlak Plot Modelling
 #include "stir/modelling/ModelMatrix.h"
 #include "stir/recon_buildblock/PoissonLogLikelihoodWithLinearKineticModelAndDynamicProjectionData.h"
@@ -72,6 +74,11 @@ PoissonLogLikelihoodWithLinearKineticModelAndDynamicProjectionData<TargetT>::set
   this->_dyn_proj_data_sptr.reset();
   this->_zero_seg0_end_planes = 0;
 
+  this->_num_frames_to_process_in_parallel = 1;
+  this->_max_memory_in_MB_for_parallel_frames = 0.;
+  this->_num_frame_slots = 1;
+  this->_frame_slot_projector_pair_sptrs.clear();
+
   this->_additive_dyn_proj_data_filename = "0";
   this->_additive_dyn_proj_data_sptr.reset();
 
@@ -105,6 +112,8 @@ PoissonLogLikelihoodWithLinearKineticModelAndDynamicProjectionData<TargetT>::ini
   // parser.add_key("mash x views", &num_views_to_add);   // KT 20/06/2001 disabled
   this->parser.add_key("maximum absolute segment number to process", &this->_max_segment_num_to_process);
   this->parser.add_key("zero end planes of segment 0", &this->_zero_seg0_end_planes);
+  this->parser.add_key("number of frames to process in parallel", &this->_num_frames_to_process_in_parallel);
+  this->parser.add_key("maximum memory in MB for parallel frames", &this->_max_memory_in_MB_for_parallel_frames);
 
   this->target_parameter_parser.add_to_keymap(this->parser);
   this->parser.add_parsing_key("Projector pair type", &this->_projector_pair_ptr);
@@ -139,6 +148,17 @@ PoissonLogLikelihoodWithLinearKineticModelAndDynamicProjectionData<TargetT>::pos
     { warning("The 'mash x views' key has an invalid value (must be 1 or even number)"); return true; }
 #endif
 
+  if (this->_num_frames_to_process_in_parallel < 1)
+    {
+      warning("The number of frames to process in parallel should be at least 1");
+      return true;
+    }
+  if (this->_max_memory_in_MB_for_parallel_frames < 0)
+    {
+      warning("The maximum memory for parallel frames should be non-negative (0 means no limit)");
+      return true;
+    }
+
   this->_dyn_proj_data_sptr = DynamicProjData::read_from_file(_input_filename);
   if (is_null_ptr(this->_dyn_proj_data_sptr))
     {
@@ -374,6 +394,45 @@ PoissonLogLikelihoodWithLinearKineticModelAndDynamicProjectionData<TargetT>::set
                                                           scanner_sptr,
                                                           density_template_sptr);
 
+    // find how many frames we can process concurrently
+    {
+      const int num_frames
+          = static_cast<int>(this->_patlak_plot_sptr->get_ending_frame() - this->_patlak_plot_sptr->get_starting_frame()) + 1;
+      this->_num_frame_slots = std::min(std::min(this->_num_frames_to_process_in_parallel, num_frames), get_max_num_threads());
+      if (this->_num_frame_slots > 1 && this->_max_memory_in_MB_for_parallel_frames > 0)
+        {
+          // estimate: the back projector keeps an image per thread, and we need an image for the
+          // forward projector input, the back projector target and the frame gradient
+          const int num_threads_per_slot = std::max(1, get_max_num_threads() / this->_num_frame_slots);
+          const double image_size_in_MB = density_template_sptr->size_all() * sizeof(float) / 1048576.;
+          const double memory_per_slot_in_MB = (num_threads_per_slot + 3) * image_size_in_MB;
+          const int max_num_slots = static_cast<int>(this->_max_memory_in_MB_for_parallel_frames / memory_per_slot_in_MB);
+          if (max_num_slots < this->_num_frame_slots)
+            {
+              this->_num_frame_slots = std::max(1, max_num_slots);
+              info(format("Reducing number of frames to process in parallel to {} to stay within {} MB",
+                          this->_num_frame_slots,
+                          this->_max_memory_in_MB_for_parallel_frames));
+            }
+        }
+      if (this->_num_frame_slots > 1)
+        info(format("Processing {} frames in parallel", this->_num_frame_slots));
+    }
+    // every slot needs its own projectors
+    this->_frame_slot_projector_pair_sptrs.resize(this->_num_frame_slots);
+    this->_frame_slot_projector_pair_sptrs[0] = this->_projector_pair_ptr;
+    for (int slot_num = 1; slot_num < this->_num_frame_slots; ++slot_num)
+      {
+        std::istringstream parameter_info_stream(this->_projector_pair_ptr->ParsingObject::parameter_info());
+        this->_frame_slot_projector_pair_sptrs[slot_num].reset(RegisteredObject<ProjectorByBinPair>::read_registered_object(
+            &parameter_info_stream, this->_projector_pair_ptr->get_registered_name()));
+        if (is_null_ptr(this->_frame_slot_projector_pair_sptrs[slot_num]))
+          {
+            warning("Could not construct a copy of the projector pair for parallel frame processing");
+            return Succeeded::no;
+          }
+      }
+
     // construct _single_frame_obj_funcs
     this->_single_frame_obj_funcs.resize(this->_patlak_plot_sptr->get_starting_frame(),
                                          this->_patlak_plot_sptr->get_ending_frame());
@@ -382,7 +441,8 @@ PoissonLogLikelihoodWithLinearKineticModelAndDynamicProjectionData<TargetT>::set
          frame_num <= this->_patlak_plot_sptr->get_ending_frame();
          ++frame_num)
       {
-        this->_single_frame_obj_funcs[frame_num].set_projector_pair_sptr(this->_projector_pair_ptr);
+        const int slot_num = (frame_num - this->_patlak_plot_sptr->get_starting_frame()) % this->_num_frame_slots;
+        this->_single_frame_obj_funcs[frame_num].set_projector_pair_sptr(this->_frame_slot_projector_pair_sptrs[slot_num]);
         this->_single_frame_obj_funcs[frame_num].set_proj_data_sptr(this->_dyn_proj_data_sptr->get_proj_data_sptr(frame_num));
         this->_single_frame_obj_funcs[frame_num].set_max_segment_num_to_process(this->_max_segment_num_to_process);
         this->_single_frame_obj_funcs[frame_num].set_zero_seg0_end_planes(this->_zero_seg0_end_planes != 0);
@@ -438,6 +498,18 @@ PoissonLogLikelihoodWithLinearKineticModelAndDynamicProjectionData<TargetT>::set
   functions that compute the value/gradient of the objective function etc
 *************************************************************************/
 
+template <typename TargetT>
+void
+PoissonLogLikelihoodWithLinearKineticModelAndDynamicProjectionData<TargetT>::process_frames(
+    const std::function<void(const unsigned int frame_num)>& frame_task) const
+{
+  const unsigned int starting_frame = this->_patlak_plot_sptr->get_starting_frame();
+  const int num_frames = static_cast<int>(this->_patlak_plot_sptr->get_ending_frame() - starting_frame) + 1;
+  // note: frames in one slot share the projectors, but are processed sequentially
+  run_tasks_in_parallel_slots(
+      num_frames, this->_num_frame_slots, [&](const int i, const int) { frame_task(starting_frame + i); });
+}
+
 template <typename TargetT>
 void
 PoissonLogLikelihoodWithLinearKineticModelAndDynamicProjectionData<TargetT>::actual_compute_subset_gradient_without_penalty(
@@ -446,7 +518,6 @@ PoissonLogLikelihoodWithLinearKineticModelAndDynamicProjectionData<TargetT>::act
   if (subset_num < 0 || subset_num >= this->get_num_subsets())
     error("compute_sub_gradient_without_penalty subset_num out-of-range error");
 
-  DynamicDiscretisedDensity dyn_gradient = this->_dyn_image_template;
   DynamicDiscretisedDensity dyn_image_estimate = this->_dyn_image_template;
 
   for (unsigned int frame_num = this->_patlak_plot_sptr->get_starting_frame();
@@ -455,19 +526,23 @@ PoissonLogLikelihoodWithLinearKineticModelAndDynamicProjectionData<TargetT>::act
     std::fill(dyn_image_estimate[frame_num].begin_all(), dyn_image_estimate[frame_num].end_all(), 1.F);
 
   this->_patlak_plot_sptr->get_dynamic_image_from_parametric_image(dyn_image_estimate, current_estimate);
+  // note: model matrix is now in the correct scale
+  const ModelMatrix<2> model_matrix = this->_patlak_plot_sptr->get_model_matrix();
 
-  // loop over single_frame and use model_matrix
-  for (unsigned int frame_num = this->_patlak_plot_sptr->get_starting_frame();
-       frame_num <= this->_patlak_plot_sptr->get_ending_frame();
-       ++frame_num)
-    {
-      std::fill(dyn_gradient[frame_num].begin_all(), dyn_gradient[frame_num].end_all(), 1.F);
+  std::fill(gradient.begin_all(), gradient.end_all(), 0.F);
+  // loop over single_frame and multiply every frame gradient with the model gradient once it is computed
+  this->process_frames([&](const unsigned int frame_num) {
+    shared_ptr<DiscretisedDensity<3, float>> frame_gradient_sptr(dyn_image_estimate[frame_num].get_empty_copy());
+    frame_gradient_sptr->fill(1.F);
 
-      this->_single_frame_obj_funcs[frame_num].actual_compute_subset_gradient_without_penalty(
-          dyn_gradient[frame_num], dyn_image_estimate[frame_num], subset_num, add_sensitivity);
-    }
+    this->_single_frame_obj_funcs[frame_num].actual_compute_subset_gradient_without_penalty(
+        *frame_gradient_sptr, dyn_image_estimate[frame_num], subset_num, add_sensitivity);
 
-  this->_patlak_plot_sptr->multiply_dynamic_image_with_model_gradient(gradient, dyn_gradient);
+#ifdef STIR_OPENMP
+#  pragma omp critical(KINETICMODEL_GRADIENT)
+#endif
+    model_matrix.multiply_frame_image_with_model_and_add_to_input(gradient, *frame_gradient_sptr, frame_num);
+  });
 }
 
 template <typename TargetT>
@@ -489,13 +564,18 @@ PoissonLogLikelihoodWithLinearKineticModelAndDynamicProjectionData<TargetT>::act
   this->_patlak_plot_sptr->get_dynamic_image_from_parametric_image(dyn_image_estimate, current_estimate);
 
   // loop over single_frame
+  VectorWithOffset<double> frame_results(this->_patlak_plot_sptr->get_starting_frame(),
+                                         this->_patlak_plot_sptr->get_ending_frame());
+  this->process_frames([&](const unsigned int frame_num) {
+    frame_results[frame_num]
+        = this->_single_frame_obj_funcs[frame_num].compute_objective_function_without_penalty(dyn_image_estimate[frame_num],
+                                                                                              subset_num);
+  });
+  // sum in frame order, such that the result does not depend on the number of frames processed in parallel
   for (unsigned int frame_num = this->_patlak_plot_sptr->get_starting_frame();
        frame_num <= this->_patlak_plot_sptr->get_ending_frame();
        ++frame_num)
-    {
-      result += this->_single_frame_obj_funcs[frame_num].compute_objective_function_without_penalty(dyn_image_estimate[frame_num],
-                                                                                                    subset_num);
-    }
+    result += frame_results[frame_num];
   return result;
 }
 
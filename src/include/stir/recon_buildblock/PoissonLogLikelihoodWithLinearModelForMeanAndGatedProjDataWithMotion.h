@@ -30,6 +30,8 @@
 #include "stir/GatedProjData.h"
 #include "stir/GatedDiscretisedDensity.h"
 #include "stir/spatial_transformation/GatedSpatialTransformation.h"
+#include <functional>
+#include <vector>
 
 START_NAMESPACE_STIR
 
@@ -46,6 +48,27 @@ _{\nu'g\rightarrow \nu}P_{\nu' b}A_{bg}+\beta \nabla_{\Lambda_{\nu}} E_{\nu}^{(s
 b}\frac{Y_{bg}}{\sum\limits_{\tilde{\nu}}P_{b\tilde{\nu}}\sum\limits_{\tilde{\nu}'}\hat{W} _{\tilde{\nu}'\rightarrow
 \tilde{\nu}g}\Lambda_{\tilde{\nu}'}^{(s)}+\frac{B_{bg}}{A_{bg}}}\right) \end{array} \f] \par Parameters for parsing
 
+ \verbatim
+ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion Parameters:=
+ ; keywords for input data, projectors, gate definitions and motion vectors, and
+ ; number of gates that are evaluated concurrently (default 1, i.e. sequentially)
+ number of gates to process in parallel := 1
+ ; store the interpolation weights of the (reverse) motion vectors (default 0)
+ precompute motion warps := 0
+ End PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion Parameters:=
+ \endverbatim
+
+ \par Gate-parallel evaluation
+ The value and gradient of the objective function are computed gate by gate: the current estimate
+ is warped to the gate, the single gate objective function is evaluated, and (for the gradient) the
+ result is warped back and added to the output. When more than 1 gate is processed in parallel,
+ every concurrent "slot" gets its own copy of the projector pair (constructed from its
+ parameter_info()), and the available OpenMP threads are divided over the slots.
+
+ With <tt>precompute motion warps</tt>, the interpolation weights of every gate are computed
+ once in set_up() (see GatedSpatialTransformation::precompute_warps()), such that warping
+ costs only a sparse matrix multiplication. This needs 4 values per voxel, gate and direction.
+
  For more information: Tsoumpas et al (2013) Physics in Medicine and Biology
 
 */
@@ -63,6 +86,16 @@ private:
       base_type;
   typedef PoissonLogLikelihoodWithLinearModelForMeanAndProjData<DiscretisedDensity<3, float>> SingleGateObjFunc;
   VectorWithOffset<SingleGateObjFunc> _single_gate_obj_funcs;
+  //! projector pairs used by the concurrent gate slots (only used when processing gates in parallel)
+  std::vector<shared_ptr<ProjectorByBinPair>> _gate_slot_projector_pair_sptrs;
+  //! number of gate slots that are actually used (determined in set_up())
+  int _num_gate_slots;
+
+  //! Calls \a gate_task for every gate, using the gate slots for concurrent evaluation
+  /*! Gate \c i+1 is always processed in slot <code>i % _num_gate_slots</code>,
+     i.e. by the projector pair in \c _gate_slot_projector_pair_sptrs with that index.
+  */
+  void process_gates(const std::function<void(const unsigned int gate_num)>& gate_task) const;
 
   TimeGateDefinitions _time_gate_definitions;
 
@@ -174,6 +207,10 @@ protected:
                                // applied//
   GatedSpatialTransformation _motion_vectors;
   GatedSpatialTransformation _reverse_motion_vectors;
+  //! maximum number of gates that are processed concurrently
+  int _num_gates_to_process_in_parallel;
+  //! if \c true, set_up() computes the interpolation weights for the motion vectors
+  bool _precompute_motion_warps;
 
   //! gated image template
   GatedDiscretisedDensity _gated_image_template;
@@ -27,7 +27,7 @@
 #include "stir/warning.h"
 #include "stir/error.h"
 #include "stir/format.h"
-#include "stir/is_null_ptr.h"
+#include "stir/num_threads.h"
 
 // include the following to set defaults
 #ifndef USE_PMRT
@@ -42,6 +42,7 @@
 
 #include <algorithm>
 #include <string>
+#include <sstream>
 // For Motion
 #include "stir/spatial_transformation/GatedSpatialTransformation.h"
 #include "stir/recon_buildblock/PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion.h"
@@ -75,6 +76,9 @@ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::s
   // this->_time_gate_definitions_sptr=NULL;
   this->_additive_gated_proj_data_filename = "0";
   this->_additive_gated_proj_data_sptr.reset();
+  this->_num_gates_to_process_in_parallel = 1;
+  this->_precompute_motion_warps = false;
+  this->_num_gate_slots = 1;
 
 #ifndef USE_PMRT // set default for _projector_pair_ptr
   shared_ptr<ForwardProjectorByBin> forward_projector_ptr(new ForwardProjectorByBinUsingRayTracing());
@@ -116,6 +120,9 @@ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::i
   this->parser.add_key("Gate Definitions filename", &this->_gate_definitions_filename);
   this->parser.add_key("Motion Vectors filename prefix", &this->_motion_vectors_filename_prefix);
   this->parser.add_key("Reverse Motion Vectors filename prefix", &this->_reverse_motion_vectors_filename_prefix);
+  this->parser.add_key("precompute motion warps", &this->_precompute_motion_warps);
+
+  this->parser.add_key("number of gates to process in parallel", &this->_num_gates_to_process_in_parallel);
 }
 
 template <typename TargetT>
@@ -148,6 +155,12 @@ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::p
 
   this->_time_gate_definitions.read_gdef_file(this->_gate_definitions_filename);
 
+  if (this->_num_gates_to_process_in_parallel < 1)
+    {
+      warning("number of gates to process in parallel should be at least 1");
+      return true;
+    }
+
   if (this->_reverse_motion_vectors_filename_prefix != "0")
     this->_reverse_motion_vectors.read_from_files(this->_reverse_motion_vectors_filename_prefix);
   if (this->_motion_vectors_filename_prefix != "0")
@@ -376,13 +389,41 @@ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::s
     const shared_ptr<Scanner> scanner_sptr(new Scanner(*proj_data_info_sptr->get_scanner_ptr()));
     this->_gated_image_template = GatedDiscretisedDensity(this->get_time_gate_definitions(), density_template_sptr);
 
+    // find how many gates we can process concurrently
+    const int num_gates = static_cast<int>(this->get_time_gate_definitions().get_num_gates());
+    this->_num_gate_slots = std::max(1, std::min(std::min(this->_num_gates_to_process_in_parallel, num_gates), get_max_num_threads()));
+    if (this->_num_gate_slots > 1)
+      info(format("Processing {} gates in parallel", this->_num_gate_slots));
+    // every slot needs its own projectors
+    this->_gate_slot_projector_pair_sptrs.resize(this->_num_gate_slots);
+    this->_gate_slot_projector_pair_sptrs[0] = this->_projector_pair_ptr;
+    for (int slot_num = 1; slot_num < this->_num_gate_slots; ++slot_num)
+      {
+        std::istringstream parameter_info_stream(this->_projector_pair_ptr->ParsingObject::parameter_info());
+        this->_gate_slot_projector_pair_sptrs[slot_num].reset(RegisteredObject<ProjectorByBinPair>::read_registered_object(
+            &parameter_info_stream, this->_projector_pair_ptr->get_registered_name()));
+        if (is_null_ptr(this->_gate_slot_projector_pair_sptrs[slot_num]))
+          {
+            warning("Could not construct a copy of the projector pair for parallel gate processing");
+            return Succeeded::no;
+          }
+      }
+
+    if (this->_precompute_motion_warps)
+      {
+        info("Precomputing interpolation weights for the motion vectors");
+        this->_motion_vectors.precompute_warps();
+        this->_reverse_motion_vectors.precompute_warps();
+      }
+
     // construct _single_gate_obj_funcs
     this->_single_gate_obj_funcs.resize(1, this->get_time_gate_definitions().get_num_gates());
 
     for (unsigned int gate_num = 1; gate_num <= this->get_time_gate_definitions().get_num_gates(); ++gate_num)
       {
         info(format("Objective Function for Gate Number: {}", gate_num));
-        this->_single_gate_obj_funcs[gate_num].set_projector_pair_sptr(this->_projector_pair_ptr);
+        const int slot_num = (gate_num - 1) % this->_num_gate_slots;
+        this->_single_gate_obj_funcs[gate_num].set_projector_pair_sptr(this->_gate_slot_projector_pair_sptrs[slot_num]);
         this->_single_gate_obj_funcs[gate_num].set_proj_data_sptr(this->_gated_proj_data_sptr->get_proj_data_sptr(gate_num));
         this->_single_gate_obj_funcs[gate_num].set_max_segment_num_to_process(this->_max_segment_num_to_process);
         this->_single_gate_obj_funcs[gate_num].set_zero_seg0_end_planes(this->_zero_seg0_end_planes != 0);
@@ -417,6 +458,16 @@ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::s
   functions that compute the value/gradient of the objective function etc
 *************************************************************************/
 
+template <typename TargetT>
+void
+PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::process_gates(
+    const std::function<void(const unsigned int gate_num)>& gate_task) const
+{
+  const int num_gates = static_cast<int>(this->get_time_gate_definitions().get_num_gates());
+  // note: gates in one slot share the projectors, but are processed sequentially
+  run_tasks_in_parallel_slots(num_gates, this->_num_gate_slots, [&](const int i, const int) { gate_task(i + 1); });
+}
+
 template <typename TargetT>
 void
 PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::actual_compute_subset_gradient_without_penalty(
@@ -425,22 +476,21 @@ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::a
   assert(subset_num >= 0);
   assert(subset_num < this->num_subsets);
 
-  GatedDiscretisedDensity gated_gradient = this->_gated_image_template;
-  GatedDiscretisedDensity gated_image_estimate = this->_gated_image_template;
-  // The following initialization doesn't stabilize reconstruction.
-  for (unsigned int gate_num = 1; gate_num <= this->get_time_gate_definitions().get_num_gates(); ++gate_num)
-    std::fill(gated_image_estimate[gate_num].begin_all(), gated_image_estimate[gate_num].end_all(), 0.F);
-  this->_motion_vectors.warp_image(gated_image_estimate, current_estimate);
-  for (unsigned int gate_num = 1; gate_num <= this->get_time_gate_definitions().get_num_gates(); ++gate_num)
-    {
-      std::fill(gated_gradient[gate_num].begin_all(), gated_gradient[gate_num].end_all(), 0.F);
-      this->_single_gate_obj_funcs[gate_num].actual_compute_subset_gradient_without_penalty(
-          gated_gradient[gate_num], gated_image_estimate[gate_num], subset_num, add_sensitivity);
-    }
-  //	if(this->_motion_correction_type==-1)
-  this->_reverse_motion_vectors.warp_image(gradient, gated_gradient);
-  //	else
-  //		  this->_motion_vectors.warp_image(gradient,gated_gradient) ;
+  std::fill(gradient.begin_all(), gradient.end_all(), 0.F);
+  // warp, gradient and reverse warp are done per gate, such that we never store all gated images
+  this->process_gates([&](const unsigned int gate_num) {
+    shared_ptr<DiscretisedDensity<3, float>> gate_image_sptr(current_estimate.get_empty_copy());
+    shared_ptr<DiscretisedDensity<3, float>> gate_gradient_sptr(current_estimate.get_empty_copy());
+    this->_motion_vectors.warp_image(*gate_image_sptr, current_estimate, gate_num);
+    this->_single_gate_obj_funcs[gate_num].actual_compute_subset_gradient_without_penalty(
+        *gate_gradient_sptr, *gate_image_sptr, subset_num, add_sensitivity);
+    //	if(this->_motion_correction_type==-1)
+    this->_reverse_motion_vectors.warp_image(*gate_image_sptr, *gate_gradient_sptr, gate_num);
+#ifdef STIR_OPENMP
+#  pragma omp critical(GATEDMOTION_GRADIENT)
+#endif
+    gradient += *gate_image_sptr;
+  });
 }
 
 template <typename TargetT>
@@ -452,17 +502,17 @@ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::a
   assert(subset_num < this->num_subsets);
 
   double result = 0.;
-  GatedDiscretisedDensity gated_image_estimate = this->_gated_image_template;
-  // The following initialization doesn't stabilize reconstruction.
-  for (unsigned int gate_num = 1; gate_num <= this->get_time_gate_definitions().get_num_gates(); ++gate_num)
-    std::fill(gated_image_estimate[gate_num].begin_all(), gated_image_estimate[gate_num].end_all(), 0.F);
-  this->_motion_vectors.warp_image(gated_image_estimate, current_estimate);
   // loop over single_gate
+  VectorWithOffset<double> gate_results(1, this->get_time_gate_definitions().get_num_gates());
+  this->process_gates([&](const unsigned int gate_num) {
+    shared_ptr<DiscretisedDensity<3, float>> gate_image_sptr(current_estimate.get_empty_copy());
+    this->_motion_vectors.warp_image(*gate_image_sptr, current_estimate, gate_num);
+    gate_results[gate_num]
+        = this->_single_gate_obj_funcs[gate_num].compute_objective_function_without_penalty(*gate_image_sptr, subset_num);
+  });
+  // sum in gate order, such that the result does not depend on the number of gates processed in parallel
   for (unsigned int gate_num = 1; gate_num <= this->get_time_gate_definitions().get_num_gates(); ++gate_num)
-    {
-      result += this->_single_gate_obj_funcs[gate_num].compute_objective_function_without_penalty(gated_image_estimate[gate_num],
-                                                                                                  subset_num);
-    }
+    result += gate_results[gate_num];
   return result;
 }
 
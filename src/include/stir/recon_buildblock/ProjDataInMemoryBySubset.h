@@ -0,0 +1,125 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup recon_buildblock
+  \brief Declaration of class stir::ProjDataInMemoryBySubset
+*/
+
+#ifndef __stir_recon_buildblock_ProjDataInMemoryBySubset_H__
+#define __stir_recon_buildblock_ProjDataInMemoryBySubset_H__
+
+#include "stir/ProjData.h"
+#include "stir/shared_ptr.h"
+#include <vector>
+
+START_NAMESPACE_STIR
+
+class DataSymmetriesForViewSegmentNumbers;
+
+/*!
+  \ingroup recon_buildblock
+  \brief A class which stores projection data in memory, grouped by subset
+
+  ProjDataInMemory stores the data by segment, axial position, view and tangential position.
+  An ordered subsets algorithm only uses some of the views in every subset, such that
+  it accesses memory with large strides.
+
+  This class stores the data per subset (as determined by detail::find_basic_vs_nums_in_subset()).
+  Within a subset, the data are grouped by basic view/segment (as determined by the symmetries),
+  then by TOF bin and finally by related view/segment. Every viewgram is contiguous. The data of
+  one subset is therefore one contiguous block, see get_subset_data_ptr(). Related viewgrams are
+  also stored next to each other, and can be obtained without copying via get_related_viewgrams_sharing_data().
+
+  The symmetries and number of subsets have to be the same as what is used by the reconstruction
+  (e.g. ProjectorByBinPair::get_symmetries_used()), otherwise there is no advantage.
+
+  Use the constructor taking a ProjData to convert existing data. Conversion to another
+  type of ProjData can be done with ProjData::fill().
+*/
+class ProjDataInMemoryBySubset : public ProjData
+{
+public:
+  //! constructor with only info, but no data
+  /*!
+    \param initialise_with_0 specifies if the data should be set to 0.
+        If \c false, the data is undefined until you set it yourself.
+    Calls error() if the subsets are not compatible with the symmetries.
+  */
+  ProjDataInMemoryBySubset(shared_ptr<const ExamInfo> const& exam_info_sptr,
+                           shared_ptr<const ProjDataInfo> const& proj_data_info_sptr,
+                           shared_ptr<const DataSymmetriesForViewSegmentNumbers> const& symmetries_sptr,
+                           const int num_subsets,
+                           const bool initialise_with_0 = true);
+
+  //! constructor that copies data from another ProjData
+  ProjDataInMemoryBySubset(const ProjData& proj_data,
+                           shared_ptr<const DataSymmetriesForViewSegmentNumbers> const& symmetries_sptr,
+                           const int num_subsets);
+
+  int get_num_subsets() const;
+
+  Viewgram<float> get_viewgram(const int view_num,
+                               const int segment_num,
+                               const bool make_num_tangential_poss_odd = false,
+                               const int timing_pos = 0) const override;
+  Succeeded set_viewgram(const Viewgram<float>& v) override;
+
+  Sinogram<float> get_sinogram(const int ax_pos_num,
+                               const int segment_num,
+                               const bool make_num_tangential_poss_odd = false,
+                               const int timing_pos = 0) const override;
+  Succeeded set_sinogram(const Sinogram<float>& s) override;
+
+  //! Get related viewgrams that use the storage of this object
+  /*! No data are copied. The viewgrams keep the storage alive, but modifying them will modify the
+      data in this object. This means that you should use them as read-only, unless you know what you are doing.
+
+      The view/segment has to be basic for \a symmetries_sptr, and the symmetries have to be the same as the ones used
+      to construct this object.
+  */
+  RelatedViewgrams<float> get_related_viewgrams_sharing_data(const ViewgramIndices&,
+                                                             const shared_ptr<DataSymmetriesForViewSegmentNumbers>& symmetries_sptr,
+                                                             const int timing_pos = 0) const;
+
+  //! set all bins to the same value
+  void fill(const float value) override;
+  //! set all bins from another ProjData object
+  /*! Uses a fast copy if \a proj_data is a ProjDataInMemoryBySubset with the same layout */
+  void fill(const ProjData& proj_data) override;
+
+  //! \name access to the data of one subset
+  //@{
+  //! number of elements in the subset
+  std::size_t get_subset_size(const int subset_num) const;
+  float* get_subset_data_ptr(const int subset_num);
+  const float* get_const_subset_data_ptr(const int subset_num) const;
+  //@}
+
+  //! check if the data of \a other are stored in the same order
+  bool has_same_layout(const ProjDataInMemoryBySubset& other) const;
+
+private:
+  shared_ptr<const DataSymmetriesForViewSegmentNumbers> symmetries_sptr;
+  int num_subsets;
+  shared_ptr<float[]> buffer_sptr;
+  std::size_t buffer_size;
+  //! offset of every viewgram in the buffer, see get_viewgram_index()
+  std::vector<std::size_t> viewgram_offsets;
+  //! offset of the start of every subset in the buffer (with an extra element at the end)
+  std::vector<std::size_t> subset_offsets;
+
+  void create_buffer(const bool initialise_with_0);
+  std::size_t get_viewgram_index(const int view_num, const int segment_num, const int timing_pos_num) const;
+  std::size_t get_viewgram_offset(const int view_num, const int segment_num, const int timing_pos_num) const;
+};
+
+END_NAMESPACE_STIR
+
+#endif
@@ -71,9 +71,23 @@ http://dx.doi.org/10.1118/1.4816676
 
     ; if next variable is set to 0, only a single view is kept in memory
    keep all views in cache:=1
+    ; optional: store the matrix in (or read it from) files with this prefix
+    ; (see below)
+   stored matrix filename prefix :=
 
 End Projection Matrix By Bin SPECT UB Parameters:=
 \endverbatim
+
+  \par Computation and storage of the matrix
+  When all views are kept in the cache, the matrix is computed for all views in set_up(),
+  in parallel when OpenMP is enabled. Otherwise, every view is computed when it is needed.
+
+  If a <tt>stored matrix filename prefix</tt> is set (and all views are kept in the cache), the
+  matrix is written in the format of ProjMatrixByBinFromFile after it has been computed, together with
+  a file <tt>prefix_SPECTUB_signature.txt</tt> that summarises the parameters, geometry,
+  attenuation map and mask. In a later set_up() with the same signature, the matrix is read
+  from file instead of being recomputed. This allows to reuse the matrix across runs (or
+  different processes). If the signature differs, the matrix is recomputed and the files overwritten.
 */
 // using namespace SPECTUB;
 class ProjMatrixByBinSPECTUB : public RegisteredParsingObject<ProjMatrixByBinSPECTUB, ProjMatrixByBin, ProjMatrixByBin>
@@ -158,6 +172,7 @@ private:
   std::string mask_type;
   std::string mask_file;
   bool keep_all_views_in_cache; //!< if set to false, only a single view is kept in memory
+  std::string stored_matrix_filename_prefix; //!< if not empty, the matrix is read from/written to file
 
   // explicitly list necessary members for image details (should use an Info object instead)
   CartesianCoordinate3D<float> voxel_size;
@@ -184,9 +199,6 @@ private:
   bool* msk_3d; //!< voxels to be included in matrix (no weight calculated outside the mask)
   bool* msk_2d; //!< 2d collapse of msk_3d.
 
-  //... variables for estimated sizes of arrays to allocate ................................
-  int** NITEMS; //!< number of non-zero elements for each weight matrix row
-
   //... user defined structures (types defined in SPECTUB_Tools.h) .....................................
 
   SPECTUB::volume_type vol; //!< structure with volume (image) information
@@ -202,7 +214,13 @@ private:
 
   int maxszb;
 
+  //! compute the matrix for one subset (i.e. view) and store it in the cache
+  /*! All arrays that are modified are local to this function, so it can be called in parallel */
   void compute_one_subset(const int kOS, const float* Rrad) const;
+  //! summary of all parameters that determine the matrix
+  std::string get_matrix_signature() const;
+  Succeeded read_matrix_from_file(const shared_ptr<const DiscretisedDensity<3, float>>& density_info_ptr);
+  void write_matrix_to_file(const shared_ptr<const DiscretisedDensity<3, float>>& density_info_ptr) const;
   void delete_UB_SPECT_arrays();
   mutable std::vector<bool> subset_already_processed;
 };
@@ -21,11 +21,13 @@
 #include "stir/GatedDiscretisedDensity.h"
 #include "stir/DiscretisedDensity.h"
 #include "stir/spatial_transformation/SpatialTransformation.h"
+#include "stir/spatial_transformation/PrecomputedLinearWarp.h"
 #include "stir/numerics/BSplinesRegularGrid.h"
 #include "stir/RegisteredParsingObject.h"
 #include "stir/Succeeded.h"
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 START_NAMESPACE_STIR
 
@@ -65,9 +67,26 @@ public:
   void warp_image(DiscretisedDensity<3, float>& new_reference_image, const GatedDiscretisedDensity& gated_image) const;
   void warp_image(GatedDiscretisedDensity& gated_image, const DiscretisedDensity<3, float>& reference_image) const;
   void accumulate_warp_image(DiscretisedDensity<3, float>& new_reference_image, const GatedDiscretisedDensity& gated_image) const;
+  //! Warp a single image with the transformation of gate \a gate_num
+  void
+  warp_image(DiscretisedDensity<3, float>& new_image, const DiscretisedDensity<3, float>& image, const unsigned int gate_num) const;
+  //! Warp a single image with the transformation of gate \a gate_num and add the result to \a new_image
+  void accumulate_warp_image(DiscretisedDensity<3, float>& new_image,
+                             const DiscretisedDensity<3, float>& image,
+                             const unsigned int gate_num) const;
+  //@}
+
+  //! Compute the interpolation weights for all gates such that they are reused by the warping functions
+  /*! This uses a PrecomputedLinearWarp per gate, which avoids constructing a B-spline
+      representation of the image for every call, at the cost of storing 4 values per voxel and gate.
+      The cache is cleared when the transformations are changed.
+  */
+  void precompute_warps();
+  bool warps_are_precomputed() const { return !this->_precomputed_warps.empty(); }
+
   void set_defaults() override;
   Succeeded set_up() override;
-  //@}
+
 private:
   typedef RegisteredParsingObject<GatedSpatialTransformation, SpatialTransformation> base_type;
   void initialise_keymap() override;
@@ -81,6 +100,8 @@ private:
   BSpline::BSplineType _spline_type;
   std::string _time_gate_definition_filename;
   TimeGateDefinitions _gate_defs;
+  //! one per gate, empty unless precompute_warps() was called
+  std::vector<PrecomputedLinearWarp> _precomputed_warps;
 };
 
 END_NAMESPACE_STIR
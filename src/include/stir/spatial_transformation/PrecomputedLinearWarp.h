@@ -0,0 +1,78 @@
+//
+/*
+ Copyright (C) 2026, University College London
+ This file is part of STIR.
+
+ SPDX-License-Identifier: Apache-2.0
+
+ See STIR/LICENSE.txt for details
+ */
+/*!
+ \file
+ \ingroup spatial_transformation
+
+ \brief Declaration of class stir::PrecomputedLinearWarp
+*/
+
+#ifndef __stir_spatial_transformation_PrecomputedLinearWarp_H__
+#define __stir_spatial_transformation_PrecomputedLinearWarp_H__
+
+#include "stir/DiscretisedDensity.h"
+#include "stir/BasicCoordinate.h"
+#include <vector>
+
+START_NAMESPACE_STIR
+
+//! Class that stores the interpolation weights for warping images with a fixed motion field
+/*!
+ \ingroup spatial_transformation
+
+ warp_image() constructs a BSplines::BSplinesRegularGrid for the input image and evaluates
+ it in every voxel. For linear interpolation, the warp is a sparse matrix with (at most) 8 non-zero
+ elements per output voxel, which only depend on the motion field. This class computes those
+ once, such that they can be reused for every image that needs to be warped with the same
+ motion field (e.g. in every sub-iteration of a motion-compensated reconstruction).
+
+ For every output voxel, we store the (linear) index of the "lower" corner of the
+ interpolation cell in the input image, and the 3 fractional distances to that corner.
+ Voxels that are warped from outside the image are set to 0, as in warp_image().
+
+ The result of warp() is identical to warp_image() with BSpline::linear (up to floating point
+ rounding errors).
+*/
+class PrecomputedLinearWarp
+{
+public:
+  PrecomputedLinearWarp();
+
+  //! Compute the interpolation weights
+  /*! The motion fields are in mm. The images that will be warped need to have the same
+      index range as the motion fields. The grid spacing is taken from \a motion_x.
+  */
+  void set_up(const DiscretisedDensity<3, float>& motion_x,
+              const DiscretisedDensity<3, float>& motion_y,
+              const DiscretisedDensity<3, float>& motion_z);
+
+  bool is_set_up() const { return !this->_corner_indices.empty(); }
+
+  //! Warp \a in_density and store the result in \a out_density
+  void warp(DiscretisedDensity<3, float>& out_density, const DiscretisedDensity<3, float>& in_density) const;
+  //! Warp \a in_density and add the result to \a out_density
+  void accumulate_warp(DiscretisedDensity<3, float>& out_density, const DiscretisedDensity<3, float>& in_density) const;
+
+private:
+  BasicCoordinate<3, int> _min_indices;
+  BasicCoordinate<3, int> _max_indices;
+  //! linear index of the lower corner of the interpolation cell in the input image, or -1 if outside
+  std::vector<long> _corner_indices;
+  //! fractional distances to the lower corner (in units of voxels)
+  std::vector<float> _fractions_z, _fractions_y, _fractions_x;
+
+  void check_range(const DiscretisedDensity<3, float>& density) const;
+  template <bool accumulate>
+  void actual_warp(DiscretisedDensity<3, float>& out_density, const DiscretisedDensity<3, float>& in_density) const;
+};
+
+END_NAMESPACE_STIR
+
+#endif
@@ -14,7 +14,7 @@
 /*
     Copyright (C) 2000 PARAPET partners
     Copyright (C) 2000- 2011, Hammersmith Imanet Ltd
-    Copyright (C) 2015, 2018-2019, University College London
+    Copyright (C) 2015, 2018-2019, 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0 AND License-ref-PARAPET-license
@@ -265,12 +265,6 @@ BackProjectorByBin::back_project(const RelatedViewgrams<float>& viewgrams,
 
   check(*viewgrams.get_proj_data_info_sptr());
 
-#ifdef STIR_OPENMP
-  const int thread_num = omp_get_thread_num();
-  if (is_null_ptr(_local_output_image_sptrs[thread_num]))
-    _local_output_image_sptrs[thread_num].reset(_density_sptr->get_empty_copy());
-#endif
-
   // first check symmetries
   {
     const ViewSegmentNumbers basic_vs = viewgrams.get_basic_view_segment_num();
@@ -298,7 +292,9 @@ BackProjectorByBin::start_accumulating_in_new_target()
   if (!this->_already_set_up)
     error("BackProjectorByBin method called without calling set_up first.");
 #ifdef STIR_OPENMP
-  if (omp_get_num_threads() != 1)
+  // Calling this from inside a parallel region is only allowed if nested parallelism is enabled, i.e. when
+  // the caller manages separate back projectors per thread (e.g. when processing frames in parallel)
+  if (omp_get_num_threads() != 1 && omp_get_active_level() >= omp_get_max_active_levels())
     error("BackProjectorByBin::start_accumulating_in_new_target cannot be called inside a thread");
 
   for (int i = 0; i < static_cast<int>(_local_output_image_sptrs.size()); ++i)
@@ -320,7 +316,8 @@ BackProjectorByBin::get_output(DiscretisedDensity<3, float>& density) const
     error("Images should have similar characteristics.");
 
 #ifdef STIR_OPENMP
-  if (omp_get_num_threads() != 1)
+  // see start_accumulating_in_new_target()
+  if (omp_get_num_threads() != 1 && omp_get_active_level() >= omp_get_max_active_levels())
     error("BackProjectorByBin::get_output() cannot be called inside a thread");
 
   // "reduce" data constructed by threads
@@ -365,13 +362,25 @@ BackProjectorByBin::actual_back_project(const RelatedViewgrams<float>& viewgrams
                                         const int min_tangential_pos_num,
                                         const int max_tangential_pos_num)
 {
-  shared_ptr<DiscretisedDensity<3, float>> density_sptr = _density_sptr;
+  actual_back_project(get_target_for_current_thread(),
+                      viewgrams,
+                      min_axial_pos_num,
+                      max_axial_pos_num,
+                      min_tangential_pos_num,
+                      max_tangential_pos_num);
+}
+
+DiscretisedDensity<3, float>&
+BackProjectorByBin::get_target_for_current_thread()
+{
 #ifdef STIR_OPENMP
   const int thread_num = omp_get_thread_num();
-  density_sptr = _local_output_image_sptrs[thread_num];
+  if (is_null_ptr(_local_output_image_sptrs[thread_num]))
+    _local_output_image_sptrs[thread_num].reset(_density_sptr->get_empty_copy());
+  return *_local_output_image_sptrs[thread_num];
+#else
+  return *_density_sptr;
 #endif
-  actual_back_project(
-      *density_sptr, viewgrams, min_axial_pos_num, max_axial_pos_num, min_tangential_pos_num, max_tangential_pos_num);
 }
 
 END_NAMESPACE_STIR
@@ -16,7 +16,7 @@
 /*
     Copyright (C) 2000 PARAPET partners
     Copyright (C) 2000- 2011, Hammersmith Imanet Ltd
-    Copyright (C) 2018, University College London
+    Copyright (C) 2018, 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0 AND License-ref-PARAPET-license
@@ -32,6 +32,7 @@
      from ForwardProjectorByBinUsingProjMatrixByBin
 */
 #include "stir/recon_buildblock/BackProjectorByBinUsingProjMatrixByBin.h"
+#include "stir/recon_buildblock/ForwardProjectorByBinUsingProjMatrixByBin.h"
 #include "stir/Viewgram.h"
 #include "stir/RelatedViewgrams.h"
 #include "stir/is_null_ptr.h"
@@ -237,4 +238,143 @@ BackProjectorByBinUsingProjMatrixByBin::clone() const
   return sptr;
 }
 
+void
+BackProjectorByBinUsingProjMatrixByBin::forward_project_transform_and_back_project(
+    const ForwardProjectorByBinUsingProjMatrixByBin& forward_projector,
+    RelatedViewgrams<float>& viewgrams,
+    const BinTransformType& bin_transform)
+{
+  if (viewgrams.get_num_viewgrams() == 0)
+    return;
+  if (forward_projector.get_proj_matrix_sptr() != proj_matrix_ptr)
+    error("BackProjectorByBinUsingProjMatrixByBin::forward_project_transform_and_back_project: "
+          "forward projector uses a different projection matrix");
+  if (!forward_projector._density_sptr)
+    error("You need to call set_input() on the forward projector before forward_project_transform_and_back_project()");
+  if (!_density_sptr)
+    error("You need to call start_accumulating_in_new_target() before forward_project_transform_and_back_project()");
+
+  check(*viewgrams.get_proj_data_info_sptr());
+
+  const DiscretisedDensity<3, float>& input_image = *forward_projector._density_sptr;
+  DiscretisedDensity<3, float>& output_image = get_target_for_current_thread();
+
+  const int min_axial_pos_num = viewgrams.get_min_axial_pos_num();
+  const int max_axial_pos_num = viewgrams.get_max_axial_pos_num();
+  const int min_tangential_pos_num = viewgrams.get_min_tangential_pos_num();
+  const int max_tangential_pos_num = viewgrams.get_max_tangential_pos_num();
+
+  // forward project the bin, transform its value, and back project it with the same row
+  auto process_bin = [&](ProjMatrixElemsForOneBin& proj_matrix_row, Viewgram<float>& viewgram, const int viewgram_index, Bin& bin) {
+    proj_matrix_row.forward_project(bin, input_image);
+    const float value = bin_transform(viewgram_index, bin);
+    viewgram[bin.axial_pos_num()][bin.tangential_pos_num()] = value;
+    // as in actual_back_project(), skip bins with value 0
+    if (value == 0)
+      return;
+    bin.set_bin_value(value);
+    proj_matrix_row.back_project(output_image, bin);
+  };
+
+  if (proj_matrix_ptr->is_cache_enabled())
+    {
+      // straightforward version which relies on ProjMatrixByBin to sort out all
+      // symmetries, see actual_back_project()
+      ProjMatrixElemsForOneBin proj_matrix_row;
+
+      int viewgram_index = 0;
+      for (RelatedViewgrams<float>::iterator r_viewgrams_iter = viewgrams.begin(); r_viewgrams_iter != viewgrams.end();
+           ++r_viewgrams_iter, ++viewgram_index)
+        {
+          Viewgram<float>& viewgram = *r_viewgrams_iter;
+          const int view_num = viewgram.get_view_num();
+          const int segment_num = viewgram.get_segment_num();
+          const int timing_num = viewgram.get_timing_pos_num();
+
+          for (int tang_pos = min_tangential_pos_num; tang_pos <= max_tangential_pos_num; ++tang_pos)
+            for (int ax_pos = min_axial_pos_num; ax_pos <= max_axial_pos_num; ++ax_pos)
+              {
+                Bin bin(segment_num, view_num, ax_pos, tang_pos, timing_num, 0.f);
+                proj_matrix_ptr->get_proj_matrix_elems_for_one_bin(proj_matrix_row, bin);
+                process_bin(proj_matrix_row, viewgram, viewgram_index, bin);
+              }
+        }
+    }
+  else
+    {
+      // complicated version which handles the symmetries explicitly, see actual_back_project()
+      ProjMatrixElemsForOneBin proj_matrix_row;
+      ProjMatrixElemsForOneBin proj_matrix_row_copy;
+      const DataSymmetriesForBins* symmetries = proj_matrix_ptr->get_symmetries_ptr();
+
+      Array<2, int> already_processed(
+          IndexRange2D(min_axial_pos_num, max_axial_pos_num, min_tangential_pos_num, max_tangential_pos_num));
+
+      vector<AxTangPosNumbers> related_ax_tang_poss;
+      for (int tang_pos = min_tangential_pos_num; tang_pos <= max_tangential_pos_num; ++tang_pos)
+        for (int ax_pos = min_axial_pos_num; ax_pos <= max_axial_pos_num; ++ax_pos)
+          {
+            if (already_processed[ax_pos][tang_pos])
+              continue;
+
+            Bin basic_bin(viewgrams.get_basic_segment_num(),
+                          viewgrams.get_basic_view_num(),
+                          ax_pos,
+                          tang_pos,
+                          viewgrams.get_basic_timing_pos_num());
+            symmetries->find_basic_bin(basic_bin);
+
+            proj_matrix_ptr->get_proj_matrix_elems_for_one_bin(proj_matrix_row, basic_bin);
+
+            related_ax_tang_poss.resize(0);
+            symmetries->get_related_bins_factorised(related_ax_tang_poss,
+                                                    basic_bin,
+                                                    min_axial_pos_num,
+                                                    max_axial_pos_num,
+                                                    min_tangential_pos_num,
+                                                    max_tangential_pos_num);
+
+            for (auto r_ax_tang_poss_iter = related_ax_tang_poss.begin(); r_ax_tang_poss_iter != related_ax_tang_poss.end();
+                 ++r_ax_tang_poss_iter)
+              {
+                const int axial_pos_tmp = (*r_ax_tang_poss_iter)[1];
+                const int tang_pos_tmp = (*r_ax_tang_poss_iter)[2];
+
+                // symmetries might take the ranges out of what the user wants
+                if (!(min_axial_pos_num <= axial_pos_tmp && axial_pos_tmp <= max_axial_pos_num
+                      && min_tangential_pos_num <= tang_pos_tmp && tang_pos_tmp <= max_tangential_pos_num))
+                  continue;
+
+                already_processed[axial_pos_tmp][tang_pos_tmp] = 1;
+
+                int viewgram_index = 0;
+                for (RelatedViewgrams<float>::iterator viewgram_iter = viewgrams.begin(); viewgram_iter != viewgrams.end();
+                     ++viewgram_iter, ++viewgram_index)
+                  {
+                    proj_matrix_row_copy = proj_matrix_row;
+                    Bin bin(viewgram_iter->get_segment_num(),
+                            viewgram_iter->get_view_num(),
+                            axial_pos_tmp,
+                            tang_pos_tmp,
+                            viewgram_iter->get_timing_pos_num(),
+                            0.f);
+
+                    unique_ptr<SymmetryOperation> symm_op_ptr = symmetries->find_symmetry_operation_from_basic_bin(bin);
+                    // bin has been changed to the basic bin, reset its coordinates
+                    bin = Bin(viewgram_iter->get_segment_num(),
+                              viewgram_iter->get_view_num(),
+                              axial_pos_tmp,
+                              tang_pos_tmp,
+                              viewgram_iter->get_timing_pos_num(),
+                              0.f);
+                    symm_op_ptr->transform_proj_matrix_elems_for_one_bin(proj_matrix_row_copy);
+                    process_bin(proj_matrix_row_copy, *viewgram_iter, viewgram_index, bin);
+                  }
+              }
+          }
+      assert(already_processed.sum()
+             == ((max_axial_pos_num - min_axial_pos_num + 1) * (max_tangential_pos_num - min_tangential_pos_num + 1)));
+    }
+}
+
 END_NAMESPACE_STIR
@@ -2,7 +2,7 @@
 //
 /*
     Copyright (C) 2003- 2007, Hammersmith Imanet Ltd
-    Copyright (C) 2014, 2018 University College London
+    Copyright (C) 2014, 2018, 2026 University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0
@@ -28,6 +28,7 @@
 #include "stir/Succeeded.h"
 #include "stir/error.h"
 #include "stir/format.h"
+#include <algorithm>
 
 START_NAMESPACE_STIR
 
@@ -86,7 +87,24 @@ BinNormalisation::check(const ExamInfo& exam_info) const
                  exam_info.parameter_info()));
 }
 
-// TODO remove duplication between apply and undo by just having 1 functino that does the loops
+void
+BinNormalisation::fill_bin_efficiencies(Viewgram<float>& efficiencies) const
+{
+  Bin bin(efficiencies.get_segment_num(), efficiencies.get_view_num(), 0, 0, efficiencies.get_timing_pos_num());
+  for (bin.axial_pos_num() = efficiencies.get_min_axial_pos_num(); bin.axial_pos_num() <= efficiencies.get_max_axial_pos_num();
+       ++bin.axial_pos_num())
+    for (bin.tangential_pos_num() = efficiencies.get_min_tangential_pos_num();
+         bin.tangential_pos_num() <= efficiencies.get_max_tangential_pos_num();
+         ++bin.tangential_pos_num())
+      efficiencies[bin.axial_pos_num()][bin.tangential_pos_num()] = this->get_bin_efficiency(bin);
+}
+
+void
+BinNormalisation::fill_bin_efficiencies(RelatedViewgrams<float>& efficiencies) const
+{
+  for (RelatedViewgrams<float>::iterator iter = efficiencies.begin(); iter != efficiencies.end(); ++iter)
+    this->fill_bin_efficiencies(*iter);
+}
 
 void
 BinNormalisation::apply(RelatedViewgrams<float>& viewgrams) const
@@ -94,13 +112,13 @@ BinNormalisation::apply(RelatedViewgrams<float>& viewgrams) const
   this->check(*viewgrams.get_proj_data_info_sptr());
   for (RelatedViewgrams<float>::iterator iter = viewgrams.begin(); iter != viewgrams.end(); ++iter)
     {
-      Bin bin(iter->get_segment_num(), iter->get_view_num(), 0, 0, iter->get_timing_pos_num());
-      for (bin.axial_pos_num() = iter->get_min_axial_pos_num(); bin.axial_pos_num() <= iter->get_max_axial_pos_num();
-           ++bin.axial_pos_num())
-        for (bin.tangential_pos_num() = iter->get_min_tangential_pos_num();
-             bin.tangential_pos_num() <= iter->get_max_tangential_pos_num();
-             ++bin.tangential_pos_num())
-          (*iter)[bin.axial_pos_num()][bin.tangential_pos_num()] /= std::max(1.E-20F, get_bin_efficiency(bin));
+      Viewgram<float> efficiencies = iter->get_empty_copy();
+      this->fill_bin_efficiencies(efficiencies);
+      std::transform(iter->begin_all(),
+                     iter->end_all(),
+                     efficiencies.begin_all_const(),
+                     iter->begin_all(),
+                     [](const float value, const float efficiency) { return value / std::max(1.E-20F, efficiency); });
     }
 }
 
@@ -110,13 +128,9 @@ BinNormalisation::undo(RelatedViewgrams<float>& viewgrams) const
   this->check(*viewgrams.get_proj_data_info_sptr());
   for (RelatedViewgrams<float>::iterator iter = viewgrams.begin(); iter != viewgrams.end(); ++iter)
     {
-      Bin bin(iter->get_segment_num(), iter->get_view_num(), 0, 0, iter->get_timing_pos_num());
-      for (bin.axial_pos_num() = iter->get_min_axial_pos_num(); bin.axial_pos_num() <= iter->get_max_axial_pos_num();
-           ++bin.axial_pos_num())
-        for (bin.tangential_pos_num() = iter->get_min_tangential_pos_num();
-             bin.tangential_pos_num() <= iter->get_max_tangential_pos_num();
-             ++bin.tangential_pos_num())
-          (*iter)[bin.axial_pos_num()][bin.tangential_pos_num()] *= this->get_bin_efficiency(bin);
+      Viewgram<float> efficiencies = iter->get_empty_copy();
+      this->fill_bin_efficiencies(efficiencies);
+      *iter *= efficiencies;
     }
 }
 
@@ -1,6 +1,6 @@
 /*
   Copyright (C) 2002-2011, Hammersmith Imanet Ltd
-  Copyright (C) 2013-2014, 2019, 2020, 2021 University College London
+  Copyright (C) 2013-2014, 2019, 2020, 2021, 2026 University College London
   Copyright (C) 2020, National Physical Laboratory
 
   This file contains is based on information supplied by Siemens but
@@ -31,6 +31,7 @@
 #include "stir/DetectionPositionPair.h"
 #include "stir/shared_ptr.h"
 #include "stir/RelatedViewgrams.h"
+#include "stir/Viewgram.h"
 #include "stir/ViewSegmentNumbers.h"
 #include "stir/IndexRange2D.h"
 #include "stir/IndexRange.h"
@@ -44,6 +45,7 @@
 #include "stir/warning.h"
 #include "stir/error.h"
 #include <algorithm>
+#include <vector>
 #include <fstream>
 #include <cctype>
 using std::ofstream;
@@ -601,6 +603,110 @@ BinNormalisationFromECAT8::get_uncalibrated_bin_efficiency(const Bin& bin) const
   return total_efficiency;
 }
 
+void
+BinNormalisationFromECAT8::fill_uncalibrated_bin_efficiencies(Viewgram<float>& efficiencies) const
+{
+  // This follows get_uncalibrated_bin_efficiency() (including the order of the additions), but
+  // computes all things that do not depend on the axial position only once.
+  const int segment_num = efficiencies.get_segment_num();
+  const int start_view = efficiencies.get_view_num() * mash;
+  const int min_ring_diff = proj_data_info_cyl_ptr->get_min_ring_difference(segment_num);
+  const int max_ring_diff = proj_data_info_cyl_ptr->get_max_ring_difference(segment_num);
+  const int min_tang_pos_num = efficiencies.get_min_tangential_pos_num();
+  const int max_tang_pos_num = efficiencies.get_max_tangential_pos_num();
+  const int num_tang_poss = max_tang_pos_num - min_tang_pos_num + 1;
+
+  float start_time = 0;
+  float end_time = 0;
+  if (this->use_dead_time())
+    {
+      if (get_exam_info_sptr()->get_time_frame_definitions().get_num_time_frames() == 0)
+        error("BinNormalisationFromECAT8: projection_data needs to have timing information to compute dead-time");
+      start_time = get_exam_info_sptr()->get_time_frame_definitions().get_start_time();
+      end_time = get_exam_info_sptr()->get_time_frame_definitions().get_end_time();
+    }
+
+  // tangential detector coordinates for every uncompressed view and tangential position
+  std::vector<DetectionPositionPair<>> tangential_det_pos_pairs(mash * num_tang_poss);
+  {
+    Bin uncompressed_bin(0, 0, 0, 0);
+    for (int view_idx = 0; view_idx < mash; ++view_idx)
+      for (int tang_idx = 0; tang_idx < num_tang_poss; ++tang_idx)
+        {
+          uncompressed_bin.view_num() = start_view + view_idx;
+          uncompressed_bin.tangential_pos_num() = min_tang_pos_num + tang_idx;
+          detail::set_detection_tangential_coords(
+              proj_data_info_cyl_uncompressed_ptr, uncompressed_bin, tangential_det_pos_pairs[view_idx * num_tang_poss + tang_idx]);
+        }
+  }
+
+  Bin bin(segment_num, efficiencies.get_view_num(), 0, 0, efficiencies.get_timing_pos_num());
+  for (bin.axial_pos_num() = efficiencies.get_min_axial_pos_num(); bin.axial_pos_num() <= efficiencies.get_max_axial_pos_num();
+       ++bin.axial_pos_num())
+    {
+      const int ring1_plus_ring2 = detail::calc_ring1_plus_ring2(bin, proj_data_info_cyl_ptr);
+      for (int tang_idx = 0; tang_idx < num_tang_poss; ++tang_idx)
+        {
+          Bin uncompressed_bin(0, 0, 0, min_tang_pos_num + tang_idx);
+          float total_efficiency = 0;
+          float view_efficiency = 0.;
+          for (int view_idx = 0; view_idx < mash; ++view_idx)
+            {
+              uncompressed_bin.view_num() = start_view + view_idx;
+              DetectionPositionPair<> detection_position_pair = tangential_det_pos_pairs[view_idx * num_tang_poss + tang_idx];
+              float lor_efficiency = 0.;
+              for (uncompressed_bin.segment_num() = min_ring_diff + (min_ring_diff + ring1_plus_ring2) % 2;
+                   uncompressed_bin.segment_num() <= max_ring_diff;
+                   uncompressed_bin.segment_num() += 2)
+                {
+                  const int geo_plane_num = detail::set_detection_axial_coords(
+                      proj_data_info_cyl_ptr, ring1_plus_ring2, uncompressed_bin, detection_position_pair);
+                  if (geo_plane_num < 0)
+                    continue;
+
+                  const DetectionPosition<>& pos1 = detection_position_pair.pos1();
+                  const DetectionPosition<>& pos2 = detection_position_pair.pos2();
+
+                  float lor_efficiency_this_pair = 1.F;
+                  if (this->use_detector_efficiencies())
+                    {
+                      lor_efficiency_this_pair = efficiency_factors[pos1.axial_coord()][pos1.tangential_coord()]
+                                                 * efficiency_factors[pos2.axial_coord()][pos2.tangential_coord()];
+                    }
+                  if (this->use_dead_time())
+                    {
+                      lor_efficiency_this_pair *= get_dead_time_efficiency(pos1, start_time, end_time)
+                                                  * get_dead_time_efficiency(pos2, start_time, end_time);
+                    }
+                  if (this->use_geometric_factors())
+                    {
+                      lor_efficiency_this_pair *= geometric_factors[geo_plane_num][uncompressed_bin.tangential_pos_num()];
+                    }
+                  if (this->use_axial_effects_factors())
+                    {
+                      lor_efficiency_this_pair /= find_axial_effects(pos1.axial_coord(), pos2.axial_coord());
+                    }
+                  lor_efficiency += lor_efficiency_this_pair;
+                }
+
+              if (this->use_crystal_interference_factors())
+                {
+                  view_efficiency += lor_efficiency
+                                     * crystal_interference_factors[uncompressed_bin.tangential_pos_num()]
+                                                                   [uncompressed_bin.view_num() % num_transaxial_crystals_per_block];
+                }
+              else
+                {
+                  view_efficiency += lor_efficiency;
+                }
+
+              total_efficiency += view_efficiency;
+            }
+          efficiencies[bin.axial_pos_num()][min_tang_pos_num + tang_idx] = total_efficiency;
+        }
+    }
+}
+
 void
 BinNormalisationFromECAT8::construct_sino_lookup_table()
 {
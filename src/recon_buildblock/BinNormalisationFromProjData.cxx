@@ -2,7 +2,7 @@
 //
 /*
     Copyright (C) 2000- 2013, Hammersmith Imanet Ltd
-    Copyright (C) 2023, 2024 University College London
+    Copyright (C) 2023, 2024, 2026 University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0
@@ -78,6 +78,12 @@ BinNormalisationFromProjData::is_TOF_only_norm() const
   return this->get_norm_proj_data_sptr()->get_num_tof_poss() > 1;
 }
 
+bool
+BinNormalisationFromProjData::is_thread_safe() const
+{
+  return true;
+}
+
 Succeeded
 BinNormalisationFromProjData::set_up(const shared_ptr<const ExamInfo>& exam_info_sptr,
                                      const shared_ptr<const ProjDataInfo>& proj_data_info_sptr)
@@ -2,7 +2,7 @@
 //
 /*
     Copyright (C) 2004, Hammersmith Imanet Ltd
-    Copyright (C) 2022, University College London
+    Copyright (C) 2022, 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0
@@ -22,12 +22,14 @@
 #include "stir/ProjDataInMemory.h"
 #include "stir/shared_ptr.h"
 #include "stir/RelatedViewgrams.h"
+#include "stir/Viewgram.h"
 #include "stir/ViewSegmentNumbers.h"
 #include "stir/Succeeded.h"
 #include "stir/warning.h"
 #include "stir/error.h"
 #include "stir/numerics/divide.h"
 #include "stir/format.h"
+#include <algorithm>
 
 START_NAMESPACE_STIR
 
@@ -239,6 +241,14 @@ BinNormalisationPETFromComponents::get_bin_efficiency(const Bin& bin) const
   return this->invnorm_proj_data_sptr->get_bin_value(copy);
 }
 
+void
+BinNormalisationPETFromComponents::fill_bin_efficiencies(Viewgram<float>& efficiencies) const
+{
+  const Viewgram<float> invnorm_viewgram
+      = this->invnorm_proj_data_sptr->get_viewgram(efficiencies.get_view_num(), efficiencies.get_segment_num());
+  std::copy(invnorm_viewgram.begin_all_const(), invnorm_viewgram.end_all_const(), efficiencies.begin_all());
+}
+
 #if 0
 shared_ptr<ProjData>
 BinNormalisationPETFromComponents::get_norm_proj_data_sptr() const
@@ -0,0 +1,223 @@
+//
+//
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup normalisation
+
+  \brief Implementation for class stir::BinNormalisationWithCache
+*/
+
+#include "stir/recon_buildblock/BinNormalisationWithCache.h"
+#include "stir/ProjDataInMemory.h"
+#include "stir/ProjDataInterfile.h"
+#include "stir/ProjDataInfo.h"
+#include "stir/RelatedViewgrams.h"
+#include "stir/Viewgram.h"
+#include "stir/ViewSegmentNumbers.h"
+#include "stir/utilities.h"
+#include "stir/is_null_ptr.h"
+#include "stir/Succeeded.h"
+#include "stir/info.h"
+#include "stir/warning.h"
+#include "stir/error.h"
+#include "stir/format.h"
+#include <algorithm>
+
+START_NAMESPACE_STIR
+
+const char* const BinNormalisationWithCache::registered_name = "With Cache";
+
+void
+BinNormalisationWithCache::set_defaults()
+{
+  base_type::set_defaults();
+  norm_to_cache_sptr.reset();
+  cache_filename = "";
+  factors_sptr.reset();
+  cached_proj_data_info_sptr.reset();
+  cached_exam_info_sptr.reset();
+}
+
+void
+BinNormalisationWithCache::initialise_keymap()
+{
+  base_type::initialise_keymap();
+  parser.add_start_key("Bin Normalisation With Cache Parameters");
+  parser.add_parsing_key("Bin Normalisation to cache", &norm_to_cache_sptr);
+  parser.add_key("cache filename", &cache_filename);
+  parser.add_stop_key("END Bin Normalisation With Cache Parameters");
+}
+
+bool
+BinNormalisationWithCache::post_processing()
+{
+  if (base_type::post_processing())
+    return true;
+  if (is_null_ptr(norm_to_cache_sptr))
+    {
+      warning("BinNormalisationWithCache: you need to set the Bin Normalisation to cache");
+      return true;
+    }
+  return false;
+}
+
+BinNormalisationWithCache::BinNormalisationWithCache()
+{
+  set_defaults();
+}
+
+BinNormalisationWithCache::BinNormalisationWithCache(shared_ptr<BinNormalisation> const& norm_to_cache_sptr_v,
+                                                     const std::string& cache_filename_v)
+{
+  set_defaults();
+  norm_to_cache_sptr = norm_to_cache_sptr_v;
+  cache_filename = cache_filename_v;
+  if (post_processing())
+    error("BinNormalisationWithCache: invalid parameters");
+}
+
+bool
+BinNormalisationWithCache::is_trivial() const
+{
+  return norm_to_cache_sptr->is_trivial();
+}
+
+bool
+BinNormalisationWithCache::is_TOF_only_norm() const
+{
+  return norm_to_cache_sptr->is_TOF_only_norm();
+}
+
+bool
+BinNormalisationWithCache::is_thread_safe() const
+{
+  return true;
+}
+
+float
+BinNormalisationWithCache::get_calibration_factor() const
+{
+  return norm_to_cache_sptr->get_calibration_factor();
+}
+
+shared_ptr<BinNormalisation>
+BinNormalisationWithCache::get_norm_to_cache_sptr() const
+{
+  return norm_to_cache_sptr;
+}
+
+shared_ptr<const ProjData>
+BinNormalisationWithCache::get_factors_sptr() const
+{
+  return factors_sptr;
+}
+
+Succeeded
+BinNormalisationWithCache::set_up(const shared_ptr<const ExamInfo>& exam_info_sptr,
+                                  const shared_ptr<const ProjDataInfo>& proj_data_info_sptr_v)
+{
+  if (base_type::set_up(exam_info_sptr, proj_data_info_sptr_v) == Succeeded::no)
+    return Succeeded::no;
+
+  // store only non-TOF factors if they are the same for all TOF bins
+  shared_ptr<const ProjDataInfo> factors_proj_data_info_sptr = proj_data_info_sptr_v;
+  if (proj_data_info_sptr_v->is_tof_data() && !norm_to_cache_sptr->is_TOF_only_norm())
+    factors_proj_data_info_sptr = proj_data_info_sptr_v->create_non_tof_clone();
+
+  if (!is_null_ptr(factors_sptr) && *cached_proj_data_info_sptr == *factors_proj_data_info_sptr
+      && *cached_exam_info_sptr == *exam_info_sptr)
+    return Succeeded::yes;
+
+  if (norm_to_cache_sptr->set_up(exam_info_sptr, factors_proj_data_info_sptr) == Succeeded::no)
+    return Succeeded::no;
+
+  this->compute_factors(exam_info_sptr, factors_proj_data_info_sptr);
+  return Succeeded::yes;
+}
+
+void
+BinNormalisationWithCache::compute_factors(const shared_ptr<const ExamInfo>& exam_info_sptr,
+                                           const shared_ptr<const ProjDataInfo>& factors_proj_data_info_sptr)
+{
+  factors_sptr.reset();
+  if (cache_filename.empty())
+    {
+      info("BinNormalisationWithCache: computing factors in memory", 2);
+      factors_sptr = std::make_shared<ProjDataInMemory>(exam_info_sptr, factors_proj_data_info_sptr);
+      factors_sptr->fill(1.F);
+      norm_to_cache_sptr->undo(*factors_sptr);
+    }
+  else
+    {
+      info(format("BinNormalisationWithCache: computing factors in file {}", cache_filename), 2);
+      {
+        ProjDataInterfile factors_file(
+            exam_info_sptr, factors_proj_data_info_sptr, cache_filename, std::ios::in | std::ios::out | std::ios::trunc);
+        factors_file.fill(1.F);
+        norm_to_cache_sptr->undo(factors_file);
+      }
+      // reopen read-only, such that the file can be memory-mapped
+      std::string header_filename = cache_filename;
+      replace_extension(header_filename, ".hs");
+      factors_sptr = ProjData::read_from_file(header_filename);
+      if (is_null_ptr(factors_sptr))
+        error(format("BinNormalisationWithCache: error reading factors from {}", header_filename));
+    }
+  cached_proj_data_info_sptr = factors_proj_data_info_sptr;
+  cached_exam_info_sptr = exam_info_sptr;
+}
+
+RelatedViewgrams<float>
+BinNormalisationWithCache::get_factors(const RelatedViewgrams<float>& viewgrams) const
+{
+  this->check(*viewgrams.get_proj_data_info_sptr());
+  const ViewSegmentNumbers vs_num = viewgrams.get_basic_view_segment_num();
+  const int timing_pos_num = cached_proj_data_info_sptr->is_tof_data() ? viewgrams.get_basic_timing_pos_num() : 0;
+  shared_ptr<DataSymmetriesForViewSegmentNumbers> symmetries_sptr(viewgrams.get_symmetries_ptr()->clone());
+  return factors_sptr->get_related_viewgrams(vs_num, symmetries_sptr, false, timing_pos_num);
+}
+
+void
+BinNormalisationWithCache::apply(RelatedViewgrams<float>& viewgrams) const
+{
+  const RelatedViewgrams<float> factors = this->get_factors(viewgrams);
+  RelatedViewgrams<float>::const_iterator factors_iter = factors.begin();
+  for (RelatedViewgrams<float>::iterator iter = viewgrams.begin(); iter != viewgrams.end(); ++iter, ++factors_iter)
+    std::transform(iter->begin_all(),
+                   iter->end_all(),
+                   factors_iter->begin_all_const(),
+                   iter->begin_all(),
+                   [](const float value, const float factor) { return value / std::max(1.E-20F, factor); });
+}
+
+void
+BinNormalisationWithCache::undo(RelatedViewgrams<float>& viewgrams) const
+{
+  viewgrams *= this->get_factors(viewgrams);
+}
+
+float
+BinNormalisationWithCache::get_bin_efficiency(const Bin& bin) const
+{
+  return norm_to_cache_sptr->get_bin_efficiency(bin);
+}
+
+void
+BinNormalisationWithCache::fill_bin_efficiencies(Viewgram<float>& efficiencies) const
+{
+  this->check(*efficiencies.get_proj_data_info_sptr());
+  const int timing_pos_num = cached_proj_data_info_sptr->is_tof_data() ? efficiencies.get_timing_pos_num() : 0;
+  const Viewgram<float> factors
+      = factors_sptr->get_viewgram(efficiencies.get_view_num(), efficiencies.get_segment_num(), false, timing_pos_num);
+  std::copy(factors.begin_all_const(), factors.end_all_const(), efficiencies.begin_all());
+}
+
+END_NAMESPACE_STIR
@@ -2,7 +2,7 @@
 //
 /*
     Copyright (C) 2020, National Physical Laboratory
-    Copyright (C) 2020 University College London
+    Copyright (C) 2020, 2026 University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0
@@ -20,6 +20,7 @@
 */
 
 #include "stir/recon_buildblock/BinNormalisationWithCalibration.h"
+#include "stir/Viewgram.h"
 #include "stir/Succeeded.h"
 #include "stir/warning.h"
 #include "stir/error.h"
@@ -72,6 +73,25 @@ BinNormalisationWithCalibration::get_calib_decay_branching_ratio_factor(const Bi
   return this->_calib_decay_branching_ratio;
 }
 
+void
+BinNormalisationWithCalibration::fill_uncalibrated_bin_efficiencies(Viewgram<float>& efficiencies) const
+{
+  Bin bin(efficiencies.get_segment_num(), efficiencies.get_view_num(), 0, 0, efficiencies.get_timing_pos_num());
+  for (bin.axial_pos_num() = efficiencies.get_min_axial_pos_num(); bin.axial_pos_num() <= efficiencies.get_max_axial_pos_num();
+       ++bin.axial_pos_num())
+    for (bin.tangential_pos_num() = efficiencies.get_min_tangential_pos_num();
+         bin.tangential_pos_num() <= efficiencies.get_max_tangential_pos_num();
+         ++bin.tangential_pos_num())
+      efficiencies[bin.axial_pos_num()][bin.tangential_pos_num()] = this->get_uncalibrated_bin_efficiency(bin);
+}
+
+void
+BinNormalisationWithCalibration::fill_bin_efficiencies(Viewgram<float>& efficiencies) const
+{
+  this->fill_uncalibrated_bin_efficiencies(efficiencies);
+  efficiencies /= this->_calib_decay_branching_ratio;
+}
+
 float
 BinNormalisationWithCalibration::get_calibration_factor() const
 {
@@ -2,7 +2,7 @@
 //
 /*
     Copyright (C) 2003- 2011, Hammersmith Imanet Ltd
-    Copyright (C) 2024, University College London
+    Copyright (C) 2024, 2026, University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0
@@ -19,6 +19,7 @@
 */
 
 #include "stir/recon_buildblock/ChainedBinNormalisation.h"
+#include "stir/Viewgram.h"
 #include "stir/is_null_ptr.h"
 #include "stir/Succeeded.h"
 #include "stir/error.h"
@@ -73,6 +74,13 @@ ChainedBinNormalisation::is_TOF_only_norm() const
          || (this->apply_second && this->apply_second->is_TOF_only_norm());
 }
 
+bool
+ChainedBinNormalisation::is_thread_safe() const
+{
+  return (!this->apply_first || this->apply_first->is_thread_safe())
+         && (!this->apply_second || this->apply_second->is_thread_safe());
+}
+
 Succeeded
 ChainedBinNormalisation::set_up(const shared_ptr<const ExamInfo>& exam_info_sptr,
                                 const shared_ptr<const ProjDataInfo>& proj_data_info_ptr)
@@ -189,6 +197,26 @@ ChainedBinNormalisation::get_bin_efficiency(const Bin& bin) const
          * (!is_null_ptr(apply_second) ? apply_second->get_bin_efficiency(bin) : 1);
 }
 
+void
+ChainedBinNormalisation::fill_bin_efficiencies(Viewgram<float>& efficiencies) const
+{
+  if (is_null_ptr(apply_first))
+    {
+      if (is_null_ptr(apply_second))
+        efficiencies.fill(1.F);
+      else
+        apply_second->fill_bin_efficiencies(efficiencies);
+      return;
+    }
+  apply_first->fill_bin_efficiencies(efficiencies);
+  if (!is_null_ptr(apply_second))
+    {
+      Viewgram<float> second_efficiencies = efficiencies.get_empty_copy();
+      apply_second->fill_bin_efficiencies(second_efficiencies);
+      efficiencies *= second_efficiencies;
+    }
+}
+
 bool
 ChainedBinNormalisation::is_first_trivial() const
 {
@@ -1,7 +1,7 @@
 /*
     Copyright (C) 2000 PARAPET partners
     Copyright (C) 2000-2011, Hammersmith Imanet Ltd
-    Copyright (C) 2014, 2016-2025 University College London
+    Copyright (C) 2014, 2016-2026 University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0 AND License-ref-PARAPET-license
@@ -49,6 +49,7 @@
 #  include "stir/recon_buildblock/ForwardProjectorByBinUsingProjMatrixByBin.h"
 #  include "stir/recon_buildblock/ProjMatrixByBinUsingRayTracing.h"
 #endif
+#include "stir/recon_buildblock/ForwardProjectorByBinUsingProjMatrixByBin.h"
 #include "stir/recon_buildblock/BackProjectorByBinUsingProjMatrixByBin.h"
 #include "stir/recon_buildblock/ProjectorByBinPairUsingSeparateProjectors.h"
 #include "stir/recon_buildblock/find_basic_vs_nums_in_subsets.h"
@@ -1418,6 +1419,76 @@ distributable_sensitivity_computation(const shared_ptr<BackProjectorByBin>& back
 
 //////////// RPC functions
 
+//! Version of RPC_process_related_viewgrams_gradient for projectors using the same projection matrix
+/*! Computes the same as the generic version, but forward projection, division and back projection
+    are done for every bin in one go, without storing the estimated viewgrams.
+    \see BackProjectorByBinUsingProjMatrixByBin::forward_project_transform_and_back_project()
+*/
+template <bool add_sensitivity>
+static void
+RPC_process_related_viewgrams_gradient_using_proj_matrix(const ForwardProjectorByBinUsingProjMatrixByBin& forward_projector,
+                                                         BackProjectorByBinUsingProjMatrixByBin& back_projector,
+                                                         RelatedViewgrams<float>& measured_viewgrams,
+                                                         int& count,
+                                                         int& count2,
+                                                         double* log_likelihood_ptr,
+                                                         const RelatedViewgrams<float>* additive_binwise_correction_ptr,
+                                                         const RelatedViewgrams<float>* mult_viewgrams_ptr)
+{
+  // store some pointers and the threshold for every viewgram, such that the bin function can find them
+  std::vector<const Viewgram<float>*> additive_viewgram_ptrs;
+  std::vector<const Viewgram<float>*> mult_viewgram_ptrs;
+  std::vector<float> small_values;
+  for (RelatedViewgrams<float>::const_iterator iter = measured_viewgrams.begin(); iter != measured_viewgrams.end(); ++iter)
+    small_values.push_back(get_divide_and_truncate_threshold(*iter));
+  if (additive_binwise_correction_ptr != NULL)
+    for (RelatedViewgrams<float>::const_iterator iter = additive_binwise_correction_ptr->begin();
+         iter != additive_binwise_correction_ptr->end();
+         ++iter)
+      additive_viewgram_ptrs.push_back(&*iter);
+  if (!add_sensitivity && mult_viewgrams_ptr != NULL)
+    for (RelatedViewgrams<float>::const_iterator iter = mult_viewgrams_ptr->begin(); iter != mult_viewgrams_ptr->end(); ++iter)
+      mult_viewgram_ptrs.push_back(&*iter);
+
+  const int min_tangential_pos_num = measured_viewgrams.get_min_tangential_pos_num();
+  const int max_tangential_pos_num = measured_viewgrams.get_max_tangential_pos_num();
+  double log_likelihood = 0;
+
+  back_projector.forward_project_transform_and_back_project(
+      forward_projector, measured_viewgrams, [&](const int viewgram_index, const Bin& bin) {
+        const int axial_pos_num = bin.axial_pos_num();
+        const int tangential_pos_num = bin.tangential_pos_num();
+        float estimated = bin.get_bin_value();
+        if (additive_binwise_correction_ptr != NULL)
+          estimated += (*additive_viewgram_ptrs[viewgram_index])[axial_pos_num][tangential_pos_num];
+
+        // see divide_and_truncate()
+        float value = 0;
+        if (tangential_pos_num >= min_tangential_pos_num + rim_truncation_sino
+            && tangential_pos_num <= max_tangential_pos_num - rim_truncation_sino)
+          {
+            const float measured = (*(measured_viewgrams.begin() + viewgram_index))[axial_pos_num][tangential_pos_num];
+            value = divide_and_truncate(measured,
+                                        estimated,
+                                        small_values[viewgram_index],
+                                        count,
+                                        count2,
+                                        log_likelihood_ptr != NULL ? &log_likelihood : NULL);
+          }
+        if (!add_sensitivity)
+          {
+            if (mult_viewgrams_ptr != NULL)
+              value -= (*mult_viewgram_ptrs[viewgram_index])[axial_pos_num][tangential_pos_num];
+            else
+              value -= 1;
+          }
+        return value;
+      });
+
+  if (log_likelihood_ptr != NULL)
+    *log_likelihood_ptr += log_likelihood;
+}
+
 template <bool add_sensitivity>
 void
 RPC_process_related_viewgrams_gradient(const shared_ptr<ForwardProjectorByBin>& forward_projector_sptr,
@@ -1431,7 +1502,27 @@ RPC_process_related_viewgrams_gradient(const shared_ptr<ForwardProjectorByBin>&
 {
   assert(measured_viewgrams_ptr != NULL);
 
-  RelatedViewgrams<float> estimated_viewgrams = measured_viewgrams_ptr->get_empty_copy();
+  {
+    // use the fused version when both projectors use the same matrix
+    auto forward_projector_ptr = dynamic_cast<const ForwardProjectorByBinUsingProjMatrixByBin*>(forward_projector_sptr.get());
+    auto back_projector_ptr = dynamic_cast<BackProjectorByBinUsingProjMatrixByBin*>(back_projector_sptr.get());
+    if (forward_projector_ptr != NULL && back_projector_ptr != NULL
+        && forward_projector_ptr->get_proj_matrix_sptr() == back_projector_ptr->get_proj_matrix_sptr())
+      {
+        RPC_process_related_viewgrams_gradient_using_proj_matrix<add_sensitivity>(*forward_projector_ptr,
+                                                                                  *back_projector_ptr,
+                                                                                  *measured_viewgrams_ptr,
+                                                                                  count,
+                                                                                  count2,
+                                                                                  log_likelihood_ptr,
+                                                                                  additive_binwise_correction_ptr,
+                                                                                  mult_viewgrams_ptr);
+        return;
+      }
+  }
+
+  RelatedViewgrams<float> estimated_viewgrams
+      = measured_viewgrams_ptr->get_empty_copy(ArrayStoragePool<float>::get_thread_local_pool());
 
   /*if (distributed::first_iteration)
     {
@@ -1493,7 +1584,8 @@ RPC_process_related_viewgrams_accumulate_loglikelihood(const shared_ptr<ForwardP
   assert(measured_viewgrams_ptr != NULL);
   assert(log_likelihood_ptr != NULL);
 
-  RelatedViewgrams<float> estimated_viewgrams = measured_viewgrams_ptr->get_empty_copy();
+  RelatedViewgrams<float> estimated_viewgrams
+      = measured_viewgrams_ptr->get_empty_copy(ArrayStoragePool<float>::get_thread_local_pool());
 
   forward_projector_sptr->forward_project(estimated_viewgrams);
 
@@ -0,0 +1,288 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup recon_buildblock
+  \brief Implementation of class stir::ProjDataInMemoryBySubset
+*/
+
+#include "stir/recon_buildblock/ProjDataInMemoryBySubset.h"
+#include "stir/recon_buildblock/find_basic_vs_nums_in_subsets.h"
+#include "stir/DataSymmetriesForViewSegmentNumbers.h"
+#include "stir/ProjDataInfo.h"
+#include "stir/RelatedViewgrams.h"
+#include "stir/Viewgram.h"
+#include "stir/Sinogram.h"
+#include "stir/IndexRange2D.h"
+#include "stir/Succeeded.h"
+#include "stir/is_null_ptr.h"
+#include "stir/warning.h"
+#include "stir/error.h"
+#include "stir/format.h"
+#include "stir/num_threads.h"
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+START_NAMESPACE_STIR
+
+static const std::size_t unset_offset = std::numeric_limits<std::size_t>::max();
+
+ProjDataInMemoryBySubset::ProjDataInMemoryBySubset(shared_ptr<const ExamInfo> const& exam_info_sptr,
+                                                   shared_ptr<const ProjDataInfo> const& proj_data_info_sptr,
+                                                   shared_ptr<const DataSymmetriesForViewSegmentNumbers> const& symmetries_sptr,
+                                                   const int num_subsets,
+                                                   const bool initialise_with_0)
+    : ProjData(exam_info_sptr, proj_data_info_sptr),
+      symmetries_sptr(symmetries_sptr),
+      num_subsets(num_subsets)
+{
+  if (is_null_ptr(symmetries_sptr))
+    error("ProjDataInMemoryBySubset: symmetries have to be set");
+  if (num_subsets < 1)
+    error(format("ProjDataInMemoryBySubset: number of subsets should be at least 1, but is {}", num_subsets));
+  this->create_buffer(initialise_with_0);
+}
+
+ProjDataInMemoryBySubset::ProjDataInMemoryBySubset(const ProjData& proj_data,
+                                                   shared_ptr<const DataSymmetriesForViewSegmentNumbers> const& symmetries_sptr,
+                                                   const int num_subsets)
+    : ProjDataInMemoryBySubset(
+        proj_data.get_exam_info_sptr(), proj_data.get_proj_data_info_sptr()->create_shared_clone(), symmetries_sptr, num_subsets, false)
+{
+  this->fill(proj_data);
+}
+
+void
+ProjDataInMemoryBySubset::create_buffer(const bool initialise_with_0)
+{
+  const int num_segments = this->get_num_segments();
+  const int num_views = this->get_num_views();
+  const int num_tof_poss = this->get_num_tof_poss();
+  this->viewgram_offsets.assign(static_cast<std::size_t>(num_tof_poss) * num_segments * num_views, unset_offset);
+  this->subset_offsets.clear();
+
+  std::size_t offset = 0;
+  std::vector<ViewSegmentNumbers> related_vs;
+  for (int subset_num = 0; subset_num < this->num_subsets; ++subset_num)
+    {
+      this->subset_offsets.push_back(offset);
+      const std::vector<ViewSegmentNumbers> basic_vs_nums = detail::find_basic_vs_nums_in_subset(*this->proj_data_info_sptr,
+                                                                                                 *this->symmetries_sptr,
+                                                                                                 this->get_min_segment_num(),
+                                                                                                 this->get_max_segment_num(),
+                                                                                                 subset_num,
+                                                                                                 this->num_subsets);
+      for (const ViewSegmentNumbers& basic_vs : basic_vs_nums)
+        {
+          this->symmetries_sptr->get_related_view_segment_numbers(related_vs, basic_vs);
+          for (int timing_pos_num = this->get_min_tof_pos_num(); timing_pos_num <= this->get_max_tof_pos_num(); ++timing_pos_num)
+            for (const ViewSegmentNumbers& vs : related_vs)
+              {
+                std::size_t& viewgram_offset
+                    = this->viewgram_offsets[this->get_viewgram_index(vs.view_num(), vs.segment_num(), timing_pos_num)];
+                if (viewgram_offset != unset_offset)
+                  error(format("ProjDataInMemoryBySubset: view {}, segment {} occurs in more than one subset. "
+                               "Are the subsets compatible with the symmetries?",
+                               vs.view_num(),
+                               vs.segment_num()));
+                viewgram_offset = offset;
+                offset += static_cast<std::size_t>(this->get_num_axial_poss(vs.segment_num())) * this->get_num_tangential_poss();
+              }
+        }
+    }
+  this->subset_offsets.push_back(offset);
+  if (std::find(this->viewgram_offsets.begin(), this->viewgram_offsets.end(), unset_offset) != this->viewgram_offsets.end())
+    error("ProjDataInMemoryBySubset: not all viewgrams occur in a subset. Are the subsets compatible with the symmetries?");
+
+  this->buffer_size = offset;
+  this->buffer_sptr = shared_ptr<float[]>(new float[this->buffer_size]);
+  // also initialise when not asked for, such that the pages are spread over the NUMA nodes
+  if (initialise_with_0 || get_parallel_first_touch())
+    fill_with_first_touch(this->buffer_sptr.get(), this->buffer_size, 0.F);
+}
+
+std::size_t
+ProjDataInMemoryBySubset::get_viewgram_index(const int view_num, const int segment_num, const int timing_pos_num) const
+{
+  if (segment_num < this->get_min_segment_num() || segment_num > this->get_max_segment_num())
+    error(format("ProjDataInMemoryBySubset: segment_num out of range: {}", segment_num));
+  if (view_num < this->get_min_view_num() || view_num > this->get_max_view_num())
+    error(format("ProjDataInMemoryBySubset: view_num out of range: {}", view_num));
+  if (timing_pos_num < this->get_min_tof_pos_num() || timing_pos_num > this->get_max_tof_pos_num())
+    error(format("ProjDataInMemoryBySubset: timing_pos_num out of range: {}", timing_pos_num));
+
+  return (static_cast<std::size_t>(timing_pos_num - this->get_min_tof_pos_num()) * this->get_num_segments()
+          + (segment_num - this->get_min_segment_num()))
+             * this->get_num_views()
+         + (view_num - this->get_min_view_num());
+}
+
+std::size_t
+ProjDataInMemoryBySubset::get_viewgram_offset(const int view_num, const int segment_num, const int timing_pos_num) const
+{
+  return this->viewgram_offsets[this->get_viewgram_index(view_num, segment_num, timing_pos_num)];
+}
+
+int
+ProjDataInMemoryBySubset::get_num_subsets() const
+{
+  return this->num_subsets;
+}
+
+std::size_t
+ProjDataInMemoryBySubset::get_subset_size(const int subset_num) const
+{
+  return this->subset_offsets.at(subset_num + 1) - this->subset_offsets.at(subset_num);
+}
+
+float*
+ProjDataInMemoryBySubset::get_subset_data_ptr(const int subset_num)
+{
+  return this->buffer_sptr.get() + this->subset_offsets.at(subset_num);
+}
+
+const float*
+ProjDataInMemoryBySubset::get_const_subset_data_ptr(const int subset_num) const
+{
+  return this->buffer_sptr.get() + this->subset_offsets.at(subset_num);
+}
+
+bool
+ProjDataInMemoryBySubset::has_same_layout(const ProjDataInMemoryBySubset& other) const
+{
+  return *this->get_proj_data_info_sptr() == *other.get_proj_data_info_sptr() && this->viewgram_offsets == other.viewgram_offsets;
+}
+
+Viewgram<float>
+ProjDataInMemoryBySubset::get_viewgram(const int view_num,
+                                       const int segment_num,
+                                       const bool make_num_tangential_poss_odd,
+                                       const int timing_pos) const
+{
+  Viewgram<float> viewgram(this->proj_data_info_sptr, ViewgramIndices(view_num, segment_num, timing_pos));
+  const float* data_ptr = this->buffer_sptr.get() + this->get_viewgram_offset(view_num, segment_num, timing_pos);
+  std::copy(data_ptr, data_ptr + viewgram.size_all(), viewgram.begin_all());
+
+  if (make_num_tangential_poss_odd && (this->get_num_tangential_poss() % 2 == 0))
+    {
+      viewgram.grow(IndexRange2D(this->get_min_axial_pos_num(segment_num),
+                                 this->get_max_axial_pos_num(segment_num),
+                                 this->get_min_tangential_pos_num(),
+                                 this->get_max_tangential_pos_num() + 1));
+    }
+  return viewgram;
+}
+
+Succeeded
+ProjDataInMemoryBySubset::set_viewgram(const Viewgram<float>& v)
+{
+  if (*this->get_proj_data_info_sptr() != *v.get_proj_data_info_sptr())
+    {
+      warning("ProjDataInMemoryBySubset::set_viewgram: viewgram has incompatible ProjDataInfo member");
+      return Succeeded::no;
+    }
+  if (v.get_num_tangential_poss() != this->get_num_tangential_poss())
+    {
+      warning("ProjDataInMemoryBySubset::set_viewgram: viewgram has incorrect number of tangential positions");
+      return Succeeded::no;
+    }
+  float* data_ptr = this->buffer_sptr.get() + this->get_viewgram_offset(v.get_view_num(), v.get_segment_num(), v.get_timing_pos_num());
+  std::copy(v.begin_all_const(), v.end_all_const(), data_ptr);
+  return Succeeded::yes;
+}
+
+Sinogram<float>
+ProjDataInMemoryBySubset::get_sinogram(const int ax_pos_num,
+                                       const int segment_num,
+                                       const bool make_num_tangential_poss_odd,
+                                       const int timing_pos) const
+{
+  Sinogram<float> sinogram(this->proj_data_info_sptr, ax_pos_num, segment_num, timing_pos);
+  const std::size_t ax_pos_offset
+      = static_cast<std::size_t>(ax_pos_num - this->get_min_axial_pos_num(segment_num)) * this->get_num_tangential_poss();
+  for (int view_num = this->get_min_view_num(); view_num <= this->get_max_view_num(); ++view_num)
+    {
+      const float* data_ptr = this->buffer_sptr.get() + this->get_viewgram_offset(view_num, segment_num, timing_pos) + ax_pos_offset;
+      std::copy(data_ptr, data_ptr + this->get_num_tangential_poss(), sinogram[view_num].begin());
+    }
+
+  if (make_num_tangential_poss_odd && (this->get_num_tangential_poss() % 2 == 0))
+    {
+      sinogram.grow(IndexRange2D(this->get_min_view_num(),
+                                 this->get_max_view_num(),
+                                 this->get_min_tangential_pos_num(),
+                                 this->get_max_tangential_pos_num() + 1));
+    }
+  return sinogram;
+}
+
+Succeeded
+ProjDataInMemoryBySubset::set_sinogram(const Sinogram<float>& s)
+{
+  if (*this->get_proj_data_info_sptr() != *s.get_proj_data_info_sptr())
+    {
+      warning("ProjDataInMemoryBySubset::set_sinogram: sinogram has incompatible ProjDataInfo member");
+      return Succeeded::no;
+    }
+  if (s.get_num_tangential_poss() != this->get_num_tangential_poss())
+    {
+      warning("ProjDataInMemoryBySubset::set_sinogram: sinogram has incorrect number of tangential positions");
+      return Succeeded::no;
+    }
+  const int segment_num = s.get_segment_num();
+  const std::size_t ax_pos_offset
+      = static_cast<std::size_t>(s.get_axial_pos_num() - this->get_min_axial_pos_num(segment_num)) * this->get_num_tangential_poss();
+  for (int view_num = this->get_min_view_num(); view_num <= this->get_max_view_num(); ++view_num)
+    {
+      float* data_ptr
+          = this->buffer_sptr.get() + this->get_viewgram_offset(view_num, segment_num, s.get_timing_pos_num()) + ax_pos_offset;
+      std::copy(s[view_num].begin(), s[view_num].end(), data_ptr);
+    }
+  return Succeeded::yes;
+}
+
+RelatedViewgrams<float>
+ProjDataInMemoryBySubset::get_related_viewgrams_sharing_data(const ViewgramIndices& viewgram_indices,
+                                                             const shared_ptr<DataSymmetriesForViewSegmentNumbers>& symmetries_used,
+                                                             const int timing_pos) const
+{
+  std::vector<ViewSegmentNumbers> related_vs;
+  symmetries_used->get_related_view_segment_numbers(related_vs, viewgram_indices);
+
+  std::vector<Viewgram<float>> viewgrams;
+  viewgrams.reserve(related_vs.size());
+  for (ViewSegmentNumbers& vs : related_vs)
+    {
+      vs.timing_pos_num() = timing_pos;
+      // shared_ptr that points into the buffer, but keeps the whole buffer alive
+      shared_ptr<float[]> data_sptr(this->buffer_sptr,
+                                    this->buffer_sptr.get() + this->get_viewgram_offset(vs.view_num(), vs.segment_num(), timing_pos));
+      viewgrams.push_back(Viewgram<float>(this->proj_data_info_sptr, vs, data_sptr));
+    }
+  return RelatedViewgrams<float>(std::move(viewgrams), symmetries_used);
+}
+
+void
+ProjDataInMemoryBySubset::fill(const float value)
+{
+  std::fill(this->buffer_sptr.get(), this->buffer_sptr.get() + this->buffer_size, value);
+}
+
+void
+ProjDataInMemoryBySubset::fill(const ProjData& proj_data)
+{
+  auto by_subset_ptr = dynamic_cast<const ProjDataInMemoryBySubset*>(&proj_data);
+  if (!is_null_ptr(by_subset_ptr) && this->has_same_layout(*by_subset_ptr))
+    std::copy(by_subset_ptr->buffer_sptr.get(), by_subset_ptr->buffer_sptr.get() + this->buffer_size, this->buffer_sptr.get());
+  else
+    ProjData::fill(proj_data);
+}
+
+END_NAMESPACE_STIR
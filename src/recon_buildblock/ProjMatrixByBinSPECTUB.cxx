@@ -1,7 +1,7 @@
 /*
     Copyright (C) 2013, Institute for Bioengineering of Catalonia
     Copyright (C) Biomedical Image Group (GIB), Universitat de Barcelona, Barcelona, Spain.
-    Copyright (C) 2013-2014, 2019, 2020, 2023 University College London
+    Copyright (C) 2013-2014, 2019, 2020, 2023, 2026 University College London
     Copyright (C) 2023 National Physical Laboratory
     This file is part of STIR.
 
@@ -37,6 +37,8 @@
 #include "stir/error.h"
 #include "stir/format.h"
 #include "stir/CPUTimer.h"
+#include "stir/recon_buildblock/ProjMatrixByBinFromFile.h"
+#include "stir/utilities.h"
 #ifdef STIR_OPENMP
 #  include "stir/num_threads.h"
 #endif
@@ -45,6 +47,7 @@
 //#include "boost/scoped_ptr.hpp"
 #include <boost/math/special_functions/fpclassify.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
 
 #include <fstream>
 #include <sstream>
@@ -88,6 +91,7 @@ ProjMatrixByBinSPECTUB::initialise_keymap()
   parser.add_key("mask type", &mask_type);
   parser.add_key("mask file", &mask_file);
   parser.add_key("keep_all_views_in_cache", &keep_all_views_in_cache);
+  parser.add_key("stored matrix filename prefix", &stored_matrix_filename_prefix);
 
   parser.add_stop_key("End Projection Matrix By Bin SPECT UB Parameters");
 }
@@ -110,6 +114,7 @@ ProjMatrixByBinSPECTUB::set_defaults()
   attenuation_map = "";
   mask_type = "no";
   mask_file = "";
+  stored_matrix_filename_prefix = "";
 }
 
 bool
@@ -639,97 +644,147 @@ ProjMatrixByBinSPECTUB::set_up(const shared_ptr<const ProjDataInfo>& proj_data_i
   else
     msk_2d = msk_3d = NULL;
 
-  //... Initialization and memory allocation for the weight matrix ...................
+  //... Initialization for the weight matrix ...................
 
   wm.NbOS = prj.NbOS; // number of rows in the weight matrix
   wm.Nvox = vol.Nvox; // number of columnes in the weight matrix
 
-  //... setting PSF maximum size (in bins) and memory allocation for PSF values .......
+  //... setting PSF maximum size (in bins) ..................................
 
   this->maxszb = max_psf_szb(ang, wmh); // maximum PSF size (horizontal component of PSF)
-  NITEMS = new int*[prj.NOS];
-  for (int kOS = 0; kOS < prj.NOS; ++kOS)
-    {
-      NITEMS[kOS] = new int[wm.NbOS];
-    }
 
-  //... double array wm.val and wm.col .....................................................
+  // note: arrays for the weight matrix are allocated in compute_one_subset(), such that subsets can be computed in parallel
 
-  if ((wm.val = new (std::nothrow) float*[wm.NbOS]) == NULL)
-    {
-      // error_wm_SPECT( 200, "wm.val[]" );
-      error("Error allocating space to store values for SPECTUB matrix");
-    }
-  if ((wm.col = new (std::nothrow) int*[wm.NbOS]) == NULL)
-    {
-      // error_wm_SPECT( 200, "wm.col[]" );
-      error("Error allocating space to store column indices for SPECTUB matrix");
-    }
+  this->already_setup = true;
+  subset_already_processed.assign(prj.NOS, false);
 
-  //... array wm.ne .........................................................................
+  //..........................................................................................
+  //... CALCULATION OF MATRICES ..............................................................
+  //..........................................................................................
 
-  if ((wm.ne = new (std::nothrow) int[wm.NbOS + 1]) == 0)
+  if (!this->stored_matrix_filename_prefix.empty() && this->read_matrix_from_file(density_info_ptr) == Succeeded::yes)
     {
-      // error_wm_SPECT(200,"wm.ne[]");
-      error("Error allocating space to store number of elements for SPECTUB matrix");
+      info(format("Read SPECT UB matrix from {}. Execution (CPU) time {} s",
+                  this->stored_matrix_filename_prefix,
+                  timer.value()),
+           2);
+      return;
     }
 
-  //... STIR indices .......................................................................
-
-  if (wm.do_save_STIR)
+  if (this->keep_all_views_in_cache)
     {
-      wm.ns = new int[prj.NbOS];
-      wm.nb = new int[prj.NbOS];
-      wm.na = new int[prj.NbOS];
+      //... LOOP: Subsets (in parallel, as all of them will be needed anyway) ..................
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+      for (int kOS = 0; kOS < prj.NOS; kOS++)
+        compute_one_subset(kOS, Rrad);
+      subset_already_processed.assign(prj.NOS, true);
+      info(format("Done computing SPECT UB matrix. Execution (CPU) time {} s ", timer.value()), 2);
 
-      wm.nx = new short int[vol.Nvox];
-      wm.ny = new short int[vol.Nvox];
-      wm.nz = new short int[vol.Nvox];
+      if (!this->stored_matrix_filename_prefix.empty())
+        this->write_matrix_to_file(density_info_ptr);
     }
+  else if (!this->stored_matrix_filename_prefix.empty())
+    warning("ProjMatrixByBinSPECTUB: the matrix is only written to file when keeping all views in cache.");
+  // wm_SPECT ends here ---------------------------------------------------------------------------------------------
+}
 
-  //... memory allocation for wmh .........................................................
-
-  wmh.index = new int[wmh.prj.NangOS];
-  wmh.Rrad = new float[wmh.prj.NangOS];
+std::string
+ProjMatrixByBinSPECTUB::get_matrix_signature() const
+{
+  std::ostringstream s;
+  s << "SPECT UB matrix signature version := 1\n";
+  s << "maximum number of sigmas := " << maximum_number_of_sigmas << '\n';
+  s << "psf type := " << psf_type << '\n';
+  s << "collimator slope := " << collimator_slope << '\n';
+  s << "collimator sigma 0(cm) := " << collimator_sigma_0 << '\n';
+  s << "attenuation type := " << attenuation_type << '\n';
+  s << "mask type := " << mask_type << '\n';
+  // the content of the attenuation map and mask are summarised via a hash
+  s << "attenuation map hash := " << (attmap ? boost::hash_range(attmap, attmap + vol.Nvox) : std::size_t(0)) << '\n';
+  s << "mask hash := " << (wmh.do_msk ? boost::hash_range(msk_3d, msk_3d + vol.Nvox) : std::size_t(0)) << '\n';
+  s << "image index range := " << densel_range.get_min_index() << ',' << densel_range.get_max_index() << ','
+    << densel_range[densel_range.get_min_index()].get_min_index() << ','
+    << densel_range[densel_range.get_min_index()].get_max_index() << ','
+    << densel_range[densel_range.get_min_index()][densel_range[densel_range.get_min_index()].get_min_index()].get_min_index()
+    << ','
+    << densel_range[densel_range.get_min_index()][densel_range[densel_range.get_min_index()].get_min_index()].get_max_index()
+    << '\n';
+  s << "voxel size := " << voxel_size << '\n';
+  s << "origin := " << origin << '\n';
+  s << "rotation radii := {";
+  for (int i = 0; i < prj.Nang; ++i)
+    s << (i == 0 ? "" : ", ") << Rrad[i];
+  s << "}\n";
+  s << proj_data_info_ptr->parameter_info();
+  return s.str();
+}
 
-  //..........................................................................................
-  //... CALCULATION OF MATRICES ..............................................................
-  //..........................................................................................
+Succeeded
+ProjMatrixByBinSPECTUB::read_matrix_from_file(const shared_ptr<const DiscretisedDensity<3, float>>& density_info_ptr)
+{
+  const std::string signature_filename = this->stored_matrix_filename_prefix + "_SPECTUB_signature.txt";
+  std::string header_filename = this->stored_matrix_filename_prefix;
+  replace_extension(header_filename, ".hpm");
+  {
+    std::ifstream signature_file(signature_filename.c_str());
+    if (!signature_file)
+      return Succeeded::no; // nothing stored yet
+    std::stringstream stored_signature;
+    stored_signature << signature_file.rdbuf();
+    if (stored_signature.str() != this->get_matrix_signature())
+      {
+        warning(format("ProjMatrixByBinSPECTUB: stored matrix {} was computed with different parameters. It will be recomputed.",
+                       this->stored_matrix_filename_prefix));
+        return Succeeded::no;
+      }
+  }
 
-  //... LOOP: Subsets .................................................................
-  subset_already_processed.assign(prj.NOS, false);
-  for (int kOS = 0; kOS < prj.NOS; kOS++)
+  ProjMatrixByBinFromFile stored_matrix;
+  if (stored_matrix.parse(header_filename.c_str()) == false)
     {
-      wmh.subset_ind = kOS;
+      warning(format("ProjMatrixByBinSPECTUB: error parsing {}. The matrix will be recomputed.", header_filename));
+      return Succeeded::no;
+    }
+  stored_matrix.set_up(this->proj_data_info_ptr, density_info_ptr);
 
-      for (int i = 0; i < prj.NangOS; i++)
+  // transfer all rows to our cache
+  Bin bin;
+  bin.segment_num() = 0;
+  for (bin.view_num() = 0; bin.view_num() < prj.Nang; ++bin.view_num())
+    for (bin.axial_pos_num() = this->proj_data_info_ptr->get_min_axial_pos_num(0);
+         bin.axial_pos_num() <= this->proj_data_info_ptr->get_max_axial_pos_num(0);
+         ++bin.axial_pos_num())
+      for (bin.tangential_pos_num() = this->proj_data_info_ptr->get_min_tangential_pos_num();
+           bin.tangential_pos_num() <= this->proj_data_info_ptr->get_max_tangential_pos_num();
+           ++bin.tangential_pos_num())
         {
-
-          wmh.index[i] = prj.order[i + kOS * prj.NangOS];
-          wmh.Rrad[i] = Rrad[wmh.index[i]];
-          if (wmh.Rrad[i] != wmh.Rrad[0])
-            wmh.fixed_Rrad = false;
+          ProjMatrixElemsForOneBin lor;
+          stored_matrix.get_proj_matrix_elems_for_one_bin(lor, bin);
+          this->cache_proj_matrix_elems_for_one_bin(lor);
         }
+  subset_already_processed.assign(prj.NOS, true);
+  return Succeeded::yes;
+}
 
-      //... NITEMS initialization  ......................
-
-      for (int i = 0; i < prj.NbOS; i++)
-        NITEMS[kOS][i] = 1;
-
-      //... size estimations ........................................................
-
-      wm_size_estimation(kOS, ang, vox, bin, vol, prj, msk_3d, msk_2d, maxszb, &gaussdens, NITEMS[kOS], wmh, Rrad);
-
-      // cout << "\nwm_SPECT. Size estimation done. time (s): " << double( clock()-ini )/CLOCKS_PER_SEC <<std::endl;
-
-      // compute_one_subset(kOS);
-    } // end of LOOP: Subsets
-
-  // delete_UB_SPECT_arrays();
-  info(format("Done estimating size of matrix. Execution (CPU) time {} s ", timer.value()), 2);
-  // wm_SPECT ends here ---------------------------------------------------------------------------------------------
-
-  this->already_setup = true;
+void
+ProjMatrixByBinSPECTUB::write_matrix_to_file(const shared_ptr<const DiscretisedDensity<3, float>>& density_info_ptr) const
+{
+  info(format("Writing SPECT UB matrix to {}", this->stored_matrix_filename_prefix));
+  if (ProjMatrixByBinFromFile::write_to_file(
+          this->stored_matrix_filename_prefix, *this, this->proj_data_info_ptr, *density_info_ptr)
+      != Succeeded::yes)
+    {
+      warning("ProjMatrixByBinSPECTUB: error writing matrix to file. It will not be reused.");
+      return;
+    }
+  // write the signature last, such that an incomplete file will never be used
+  const std::string signature_filename = this->stored_matrix_filename_prefix + "_SPECTUB_signature.txt";
+  std::ofstream signature_file(signature_filename.c_str());
+  signature_file << this->get_matrix_signature();
+  if (!signature_file)
+    warning(format("ProjMatrixByBinSPECTUB: error writing {}", signature_filename));
 }
 
 ProjMatrixByBinSPECTUB*
@@ -763,19 +818,10 @@ ProjMatrixByBinSPECTUB::delete_UB_SPECT_arrays()
         }
     }
 
-  delete[] wm.val;
-  delete[] wm.col;
-  delete[] wm.ne;
-
   //... freeing memory .............................................
 
   delete[] prj.order;
   delete[] ang;
-  for (int kOS = 0; kOS < prj.NOS; ++kOS)
-    delete[] NITEMS[kOS];
-  delete[] NITEMS;
-  delete[] wmh.index;
-  delete[] wmh.Rrad;
 
   if (wmh.do_psf)
     {
@@ -790,16 +836,6 @@ ProjMatrixByBinSPECTUB::delete_UB_SPECT_arrays()
       delete[] msk_3d;
       delete[] msk_2d;
     }
-
-  if (wm.do_save_STIR)
-    {
-      delete[] wm.ns;
-      delete[] wm.nb;
-      delete[] wm.na;
-      delete[] wm.nx;
-      delete[] wm.ny;
-      delete[] wm.nz;
-    }
 }
 void
 ProjMatrixByBinSPECTUB::compute_one_subset(const int kOS, const float* Rrad) const
@@ -809,31 +845,38 @@ ProjMatrixByBinSPECTUB::compute_one_subset(const int kOS, const float* Rrad) con
   timer.start();
   // cout << "\n\n--- Processing subset: " << kOS+1 << "/" << prj.NOS << " ----------------------------------------\n" << endl;
 
+  // note: all arrays used here are local, such that different subsets can be computed in parallel
+
   //... to fill wmh fields related to the subset ..................................
 
-  this->wmh.subset_ind = kOS;
+  wmh_type wmh = this->wmh;
+  std::vector<int> wmh_index(prj.NangOS);
+  std::vector<float> wmh_Rrad(prj.NangOS);
+  wmh.index = wmh_index.data();
+  wmh.Rrad = wmh_Rrad.data();
+  wmh.subset_ind = kOS;
 
   for (int i = 0; i < prj.NangOS; i++)
     {
 
-      this->wmh.index[i] = prj.order[i + kOS * prj.NangOS];
-      this->wmh.Rrad[i] = Rrad[this->wmh.index[i]];
+      wmh.index[i] = prj.order[i + kOS * prj.NangOS];
+      wmh.Rrad[i] = Rrad[wmh.index[i]];
+      if (wmh.Rrad[i] != wmh.Rrad[0])
+        wmh.fixed_Rrad = false;
     }
 
   //... NITEMS initialization  ......................
 
-  // for ( int i = 0 ; i < prj.NbOS ; i++ ) NITEMS[ i ] = 1;
-
-  //... size esmitations ........................................................
+  std::vector<int> NITEMS(prj.NbOS, 1);
 
-  // wm_size_estimation ( kOS,  ang, vox, bin, vol, prj, msk_3d, msk_2d, maxszb, &gaussdens, NITEMS );
+  //... size estimations ........................................................
 
-  // cout << "\nwm_SPECT. Size estimation done. time (s): " << double( clock()-ini )/CLOCKS_PER_SEC <<endl;
+  wm_size_estimation(kOS, ang, vox, bin, vol, prj, msk_3d, msk_2d, maxszb, &gaussdens, NITEMS.data(), wmh, Rrad);
 
   int ne = 0;
 
-  for (int i = 0; i < this->wmh.prj.NbOS; i++)
-    ne += NITEMS[kOS][i];
+  for (int i = 0; i < wmh.prj.NbOS; i++)
+    ne += NITEMS[i];
 
   //... size information ....................................................................
 
@@ -842,72 +885,63 @@ ProjMatrixByBinSPECTUB::compute_one_subset(const int kOS, const float* Rrad) con
               (this->wm.do_save_STIR ? (ne + 10 * prj.NbOS) / 104857.6 : ne / 131072)),
        2);
 
-  //... memory allocation for wm float arrays ...................................
-
-  for (int i = 0; i < this->wmh.prj.NbOS; i++)
-    {
-
-      if ((this->wm.val[i] = new (std::nothrow) float[NITEMS[kOS][i]]) == NULL)
-        {
-          // error_wm_SPECT( 200, "wm.val[][]" );
-          error("Error allocating space to store values for SPECTUB matrix");
-        }
-
-      if ((this->wm.col[i] = new (std::nothrow) int[NITEMS[kOS][i]]) == NULL)
-        {
-          // error_wm_SPECT( 200, "wm.col[]" );
-          error("Error allocating space to store column indices for SPECTUB matrix");
-        }
-    }
-
-  //... to initialize wm to zero ......................
-
-  for (int i = 0; i < this->wm.NbOS; i++)
-    {
-
-      this->wm.ne[i] = 0;
-
-      for (int j = 0; j < NITEMS[kOS][i]; j++)
-        {
-
-          this->wm.val[i][j] = (float)0.;
-          this->wm.col[i][j] = 0;
-        }
-    }
-  this->wm.ne[this->wm.NbOS] = 0;
+  //... memory allocation for wm arrays (initialised to zero) ...................................
+
+  wm_da_type wm = this->wm;
+  std::vector<std::vector<float>> wm_val(wm.NbOS);
+  std::vector<std::vector<int>> wm_col(wm.NbOS);
+  std::vector<float*> wm_val_ptrs(wm.NbOS);
+  std::vector<int*> wm_col_ptrs(wm.NbOS);
+  for (int i = 0; i < wm.NbOS; i++)
+    {
+      wm_val[i].assign(NITEMS[i], 0.F);
+      wm_col[i].assign(NITEMS[i], 0);
+      wm_val_ptrs[i] = wm_val[i].data();
+      wm_col_ptrs[i] = wm_col[i].data();
+    }
+  std::vector<int> wm_ne(wm.NbOS + 1, 0);
+  std::vector<int> wm_ns(wm.NbOS), wm_nb(wm.NbOS), wm_na(wm.NbOS);
+  std::vector<short int> wm_nx(vol.Nvox), wm_ny(vol.Nvox), wm_nz(vol.Nvox);
+  wm.val = wm_val_ptrs.data();
+  wm.col = wm_col_ptrs.data();
+  wm.ne = wm_ne.data();
+  wm.ns = wm_ns.data();
+  wm.nb = wm_nb.data();
+  wm.na = wm_na.data();
+  wm.nx = wm_nx.data();
+  wm.ny = wm_ny.data();
+  wm.nz = wm_nz.data();
 
   //... wm calculation for this subset ...........................
 
-  wm_calculation(
-      kOS, ang, vox, bin, vol, prj, attmap, msk_3d, msk_2d, maxszb, &gaussdens, NITEMS[kOS], this->wm, this->wmh, Rrad);
+  wm_calculation(kOS, ang, vox, bin, vol, prj, attmap, msk_3d, msk_2d, maxszb, &gaussdens, NITEMS.data(), wm, wmh, Rrad);
   info(format("Weight matrix calculation done. time {} (s)", timer.value()), 2);
 
   //... fill lor .........................
 
-  for (int j = 0; j < this->wm.NbOS; j++)
+  for (int j = 0; j < wm.NbOS; j++)
     {
       ProjMatrixElemsForOneBin lor;
       Bin bin;
       bin.segment_num() = 0;
-      bin.view_num() = this->wm.na[j];
-      bin.axial_pos_num() = this->wm.ns[j];
-      bin.tangential_pos_num() = this->wm.nb[j];
+      bin.view_num() = wm.na[j];
+      bin.axial_pos_num() = wm.ns[j];
+      bin.tangential_pos_num() = wm.nb[j];
       bin.set_bin_value(0);
       lor.set_bin(bin);
 
-      lor.reserve(this->wm.ne[j]);
-      for (int i = 0; i < this->wm.ne[j]; i++)
+      lor.reserve(wm.ne[j]);
+      for (int i = 0; i < wm.ne[j]; i++)
         {
 
-          const ProjMatrixElemsForOneBin::value_type elem(Coordinate3D<int>(this->wm.nz[this->wm.col[j][i]],
-                                                                            this->wm.ny[this->wm.col[j][i]],
-                                                                            this->wm.nx[this->wm.col[j][i]]),
-                                                          this->wm.val[j][i]);
+          const ProjMatrixElemsForOneBin::value_type elem(
+              Coordinate3D<int>(wm.nz[wm.col[j][i]], wm.ny[wm.col[j][i]], wm.nx[wm.col[j][i]]), wm.val[j][i]);
           lor.push_back(elem);
         }
 
-      delete[] this->wm.val[j];
-      delete[] this->wm.col[j];
+      // free memory as we go
+      std::vector<float>().swap(wm_val[j]);
+      std::vector<int>().swap(wm_col[j]);
 
       this->cache_proj_matrix_elems_for_one_bin(lor);
     }
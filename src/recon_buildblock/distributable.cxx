@@ -1,7 +1,7 @@
 /*
     Copyright (C) 2000 PARAPET partners
     Copyright (C) 2000 - 2011, Hammersmith Imanet Ltd
-    Copyright (C) 2013-2014, 2017-2022, 2024 University College London
+    Copyright (C) 2013-2014, 2017-2022, 2024, 2026 University College London
     Copyright (C) 2020, 2022, Univeristy of Pennsylvania
     This file is part of STIR.
 
@@ -38,6 +38,8 @@
 #include "stir/shared_ptr.h"
 #include "stir/recon_buildblock/distributable.h"
 #include "stir/RelatedViewgrams.h"
+#include "stir/ArrayStoragePool.h"
+#include "stir/recon_buildblock/ProjDataInMemoryBySubset.h"
 #include "stir/ProjData.h"
 #include "stir/ExamInfo.h"
 #include "stir/DiscretisedDensity.h"
@@ -175,43 +177,65 @@ get_viewgrams(shared_ptr<RelatedViewgrams<float>>& y,
 {
   if (!is_null_ptr(binwise_correction))
     {
+      // the additive viewgrams are not modified (unless we need to zero the end planes), so we can avoid copying them
+      auto binwise_correction_by_subset_ptr = dynamic_cast<const ProjDataInMemoryBySubset*>(binwise_correction.get());
+      if (!is_null_ptr(binwise_correction_by_subset_ptr) && !(view_segment_num.segment_num() == 0 && zero_seg0_end_planes))
+        additive_binwise_correction_viewgrams.reset(new RelatedViewgrams<float>(
+            binwise_correction_by_subset_ptr->get_related_viewgrams_sharing_data(view_segment_num, symmetries_ptr, timing_pos_num)));
+      else
+        {
 #ifdef STIR_OPENMP
 #  pragma omp critical(ADDSINO)
 #endif
-      additive_binwise_correction_viewgrams.reset(new RelatedViewgrams<float>(
-          binwise_correction->get_related_viewgrams(view_segment_num, symmetries_ptr, false, timing_pos_num)));
+          additive_binwise_correction_viewgrams.reset(new RelatedViewgrams<float>(
+              binwise_correction->get_related_viewgrams(view_segment_num, symmetries_ptr, false, timing_pos_num)));
+        }
     }
 
+  // empty viewgrams use storage from a pool, such that it is reused for the next view/segment/TOF bin
+  const ViewgramIndices viewgram_indices(view_segment_num.view_num(), view_segment_num.segment_num(), timing_pos_num);
   if (read_from_proj_dat)
     {
+      // reading from ProjDataInMemoryBySubset is thread-safe
+      if (!is_null_ptr(dynamic_cast<const ProjDataInMemoryBySubset*>(proj_dat_ptr.get())))
+        y.reset(new RelatedViewgrams<float>(
+            proj_dat_ptr->get_related_viewgrams(view_segment_num, symmetries_ptr, false, timing_pos_num)));
+      else
+        {
 #ifdef STIR_OPENMP
 #  pragma omp critical(VIEW)
 #endif
-      y.reset(new RelatedViewgrams<float>(
-          proj_dat_ptr->get_related_viewgrams(view_segment_num, symmetries_ptr, false, timing_pos_num)));
+          y.reset(new RelatedViewgrams<float>(
+              proj_dat_ptr->get_related_viewgrams(view_segment_num, symmetries_ptr, false, timing_pos_num)));
+        }
     }
   else
     {
       y.reset(new RelatedViewgrams<float>(
-          proj_dat_ptr->get_empty_related_viewgrams(view_segment_num, symmetries_ptr, false, timing_pos_num)));
+          proj_dat_ptr->get_proj_data_info_sptr(), viewgram_indices, symmetries_ptr, ArrayStoragePool<float>::get_thread_local_pool()));
     }
 
   // multiplicative correction
   if (!is_null_ptr(normalisation_sptr) && !normalisation_sptr->is_trivial())
     {
       mult_viewgrams_sptr.reset(new RelatedViewgrams<float>(
-          proj_dat_ptr->get_empty_related_viewgrams(view_segment_num, symmetries_ptr, false, timing_pos_num)));
+          proj_dat_ptr->get_proj_data_info_sptr(), viewgram_indices, symmetries_ptr, ArrayStoragePool<float>::get_thread_local_pool()));
       mult_viewgrams_sptr->fill(1.F);
+      if (normalisation_sptr->is_thread_safe())
+        normalisation_sptr->undo(*mult_viewgrams_sptr);
+      else
+        {
 #ifdef STIR_OPENMP
 #  pragma omp critical(MULT)
 #endif
-      normalisation_sptr->undo(*mult_viewgrams_sptr);
+          normalisation_sptr->undo(*mult_viewgrams_sptr);
+        }
     }
   else if (zero_seg0_end_planes)
     {
       // No normalisation provided but zero_seg0_end_planes, create a mult_viewgrams
-      mult_viewgrams_sptr.reset(
-          new RelatedViewgrams<float>(proj_dat_ptr->get_empty_related_viewgrams(view_segment_num, symmetries_ptr)));
+      mult_viewgrams_sptr.reset(new RelatedViewgrams<float>(
+          proj_dat_ptr->get_proj_data_info_sptr(), view_segment_num, symmetries_ptr, ArrayStoragePool<float>::get_thread_local_pool()));
       mult_viewgrams_sptr->fill(1.F);
     }
 
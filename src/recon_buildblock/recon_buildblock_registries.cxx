@@ -47,6 +47,7 @@
 #include "stir/recon_buildblock/TrivialBinNormalisation.h"
 #include "stir/recon_buildblock/ChainedBinNormalisation.h"
 #include "stir/recon_buildblock/BinNormalisationFromProjData.h"
+#include "stir/recon_buildblock/BinNormalisationWithCache.h"
 #include "stir/recon_buildblock/BinNormalisationSPECT.h"
 #include "stir/recon_buildblock/BinNormalisationFromAttenuationImage.h"
 
@@ -128,6 +129,7 @@ static ChainedBinNormalisation::RegisterIt dummy92;
 static BinNormalisationFromProjData::RegisterIt dummy93;
 static BinNormalisationFromAttenuationImage::RegisterIt dummy94;
 static BinNormalisationSPECT::RegisterIt dummy95;
+static BinNormalisationWithCache::RegisterIt dummy96;
 static PoissonLogLikelihoodWithLinearKineticModelAndDynamicProjectionData<ParametricVoxelsOnCartesianGrid>::RegisterIt Dummyxxx;
 static PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<DiscretisedDensity<3, float>>::RegisterIt Dummyxxxzz;
 
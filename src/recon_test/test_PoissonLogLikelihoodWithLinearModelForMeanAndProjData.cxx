@@ -1,6 +1,6 @@
 /*
     Copyright (C) 2011, Hammersmith Imanet Ltd
-    Copyright (C) 2013, 2021, 2024 University College London
+    Copyright (C) 2013, 2021, 2024, 2026 University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0
@@ -32,12 +32,18 @@
 #include "stir/ProjDataInfo.h"
 #include "stir/ProjDataInMemory.h"
 #include "stir/SegmentByView.h"
+#include "stir/RelatedViewgrams.h"
 #include "stir/Scanner.h"
 #include "stir/DataSymmetriesForViewSegmentNumbers.h"
 #include "stir/recon_buildblock/PoissonLogLikelihoodWithLinearModelForMeanAndProjData.h"
 #include "stir/recon_buildblock/ProjMatrixByBinUsingRayTracing.h"
 #include "stir/recon_buildblock/ProjectorByBinPairUsingProjMatrixByBin.h"
+#include "stir/recon_buildblock/ProjectorByBinPairUsingSeparateProjectors.h"
+#include "stir/recon_buildblock/ForwardProjectorByBinUsingProjMatrixByBin.h"
+#include "stir/recon_buildblock/BackProjectorByBinUsingProjMatrixByBin.h"
+#include "stir/recon_buildblock/ProjDataInMemoryBySubset.h"
 #include "stir/recon_buildblock/BinNormalisationFromProjData.h"
+#include "stir/recon_buildblock/BinNormalisationWithCache.h"
 #include "stir/recon_buildblock/TrivialBinNormalisation.h"
 #include "stir/recon_buildblock/QuadraticPrior.h"
 //#include "stir/OSMAPOSL/OSMAPOSLReconstruction.h"
@@ -46,6 +52,7 @@
 #include "stir/IO/write_to_file.h"
 #include "stir/info.h"
 #include "stir/Succeeded.h"
+#include "stir/is_null_ptr.h"
 #include "stir/num_threads.h"
 #include <boost/random/uniform_01.hpp>
 #include <boost/random/normal_distribution.hpp>
@@ -112,6 +119,15 @@ protected:
 
   //! Test the approximate Hessian of the objective function by testing the (x^T Hx > 0) condition
   void test_approximate_Hessian_concavity(objective_function_type& objective_function, target_type& target);
+
+  //! Test that caching the normalisation factors (in memory or in a file) gives the same gradient
+  void test_normalisation_cache(const shared_ptr<target_type>& target_sptr);
+
+  //! Test that the fused forward/back projection for a projection matrix gives the same gradient as separate projectors
+  void test_gradient_using_proj_matrix(const shared_ptr<target_type>& target_sptr);
+
+  //! Test that storing the data with ProjDataInMemoryBySubset gives the same gradient
+  void test_proj_data_by_subset(const shared_ptr<target_type>& target_sptr);
 };
 
 PoissonLogLikelihoodWithLinearModelForMeanAndProjDataTests::PoissonLogLikelihoodWithLinearModelForMeanAndProjDataTests(
@@ -174,6 +190,113 @@ PoissonLogLikelihoodWithLinearModelForMeanAndProjDataTests::test_approximate_Hes
     }
 }
 
+void
+PoissonLogLikelihoodWithLinearModelForMeanAndProjDataTests::test_normalisation_cache(const shared_ptr<target_type>& target_sptr)
+{
+  auto& objective_function = *this->objective_function_sptr;
+  const shared_ptr<BinNormalisation> norm_sptr = objective_function.get_normalisation_sptr();
+  shared_ptr<target_type> gradient_sptr(target_sptr->get_empty_copy());
+  objective_function.compute_sub_gradient_without_penalty(*gradient_sptr, *target_sptr, 0);
+
+  for (const std::string& cache_filename : { std::string(), std::string("test_normalisation_cache.hs") })
+    {
+      auto cached_norm_sptr = std::make_shared<BinNormalisationWithCache>(norm_sptr, cache_filename);
+      objective_function.set_normalisation_sptr(cached_norm_sptr);
+      if (!check(objective_function.set_up(target_sptr) == Succeeded::yes, "set-up of objective function with norm cache"))
+        break;
+      check(!is_null_ptr(cached_norm_sptr->get_factors_sptr()), "norm cache should have factors");
+      check_if_equal(cached_norm_sptr->get_factors_sptr()->get_num_tof_poss(), 1, "norm cache should be non-TOF");
+      {
+        // compare bulk efficiencies with undo()
+        shared_ptr<DataSymmetriesForViewSegmentNumbers> symmetries_sptr(
+            objective_function.get_projector_pair().get_symmetries_used()->clone());
+        auto efficiencies = proj_data_sptr->get_empty_related_viewgrams(ViewSegmentNumbers(1, 0), symmetries_sptr);
+        auto undone_ones = efficiencies;
+        undone_ones.fill(1.F);
+        cached_norm_sptr->undo(undone_ones);
+        cached_norm_sptr->fill_bin_efficiencies(efficiencies);
+        for (auto iter = efficiencies.begin(), undone_iter = undone_ones.begin(); iter != efficiencies.end(); ++iter, ++undone_iter)
+          check_if_equal(*iter, *undone_iter, "fill_bin_efficiencies with norm cache should be consistent with undo");
+      }
+      shared_ptr<target_type> cached_gradient_sptr(target_sptr->get_empty_copy());
+      objective_function.compute_sub_gradient_without_penalty(*cached_gradient_sptr, *target_sptr, 0);
+      check_if_equal(*gradient_sptr, *cached_gradient_sptr, "gradient with norm cache " + cache_filename);
+    }
+  objective_function.set_normalisation_sptr(norm_sptr);
+  check(objective_function.set_up(target_sptr) == Succeeded::yes, "set-up of objective function after norm cache");
+}
+
+void
+PoissonLogLikelihoodWithLinearModelForMeanAndProjDataTests::test_gradient_using_proj_matrix(const shared_ptr<target_type>& target_sptr)
+{
+  auto& objective_function = *this->objective_function_sptr;
+  const shared_ptr<ProjectorByBinPair> proj_pair_sptr = objective_function.get_projector_pair_sptr();
+  shared_ptr<target_type> gradient_sptr(target_sptr->get_empty_copy());
+  objective_function.compute_sub_gradient_without_penalty(*gradient_sptr, *target_sptr, 0);
+  shared_ptr<target_type> gradient_plus_sens_sptr(target_sptr->get_empty_copy());
+  objective_function.compute_sub_gradient_without_penalty_plus_sensitivity(*gradient_plus_sens_sptr, *target_sptr, 0);
+
+  // projectors with different (but identical) matrices will not use the fused version
+  auto separate_proj_pair_sptr = std::make_shared<ProjectorByBinPairUsingSeparateProjectors>(
+      std::make_shared<ForwardProjectorByBinUsingProjMatrixByBin>(std::make_shared<ProjMatrixByBinUsingRayTracing>()),
+      std::make_shared<BackProjectorByBinUsingProjMatrixByBin>(std::make_shared<ProjMatrixByBinUsingRayTracing>()));
+  objective_function.set_projector_pair_sptr(separate_proj_pair_sptr);
+  if (check(objective_function.set_up(target_sptr) == Succeeded::yes, "set-up of objective function with separate projectors"))
+    {
+      shared_ptr<target_type> separate_gradient_sptr(target_sptr->get_empty_copy());
+      objective_function.compute_sub_gradient_without_penalty(*separate_gradient_sptr, *target_sptr, 0);
+      check_if_equal(*gradient_sptr, *separate_gradient_sptr, "gradient with fused and separate projectors");
+      objective_function.compute_sub_gradient_without_penalty_plus_sensitivity(*separate_gradient_sptr, *target_sptr, 0);
+      check_if_equal(
+          *gradient_plus_sens_sptr, *separate_gradient_sptr, "gradient plus sensitivity with fused and separate projectors");
+    }
+  objective_function.set_projector_pair_sptr(proj_pair_sptr);
+  check(objective_function.set_up(target_sptr) == Succeeded::yes, "set-up of objective function after separate projectors");
+}
+
+void
+PoissonLogLikelihoodWithLinearModelForMeanAndProjDataTests::test_proj_data_by_subset(const shared_ptr<target_type>& target_sptr)
+{
+  auto& objective_function = *this->objective_function_sptr;
+  const shared_ptr<ProjData> proj_data_sptr = objective_function.get_proj_data_sptr();
+  const shared_ptr<ProjData> add_proj_data_sptr = objective_function.get_additive_proj_data_sptr();
+  const int num_subsets = objective_function.get_num_subsets();
+  shared_ptr<const DataSymmetriesForViewSegmentNumbers> symmetries_sptr(
+      objective_function.get_projector_pair().get_symmetries_used()->clone());
+
+  auto proj_data_by_subset_sptr = std::make_shared<ProjDataInMemoryBySubset>(*proj_data_sptr, symmetries_sptr, num_subsets);
+  auto add_proj_data_by_subset_sptr = std::make_shared<ProjDataInMemoryBySubset>(*add_proj_data_sptr, symmetries_sptr, num_subsets);
+  {
+    std::size_t total_size = 0;
+    for (int subset_num = 0; subset_num < num_subsets; ++subset_num)
+      total_size += proj_data_by_subset_sptr->get_subset_size(subset_num);
+    check_if_equal(total_size, proj_data_sptr->size_all(), "ProjDataInMemoryBySubset: sum of subset sizes");
+    // check conversion (and conversion back)
+    ProjDataInMemory proj_data_copy(proj_data_sptr->get_exam_info_sptr(), proj_data_sptr->get_proj_data_info_sptr());
+    proj_data_copy.fill(*proj_data_by_subset_sptr);
+    for (int segment_num = proj_data_sptr->get_min_segment_num(); segment_num <= proj_data_sptr->get_max_segment_num();
+         ++segment_num)
+      check_if_equal(proj_data_sptr->get_segment_by_sinogram(segment_num),
+                     proj_data_copy.get_segment_by_sinogram(segment_num),
+                     "ProjDataInMemoryBySubset: conversion");
+  }
+
+  shared_ptr<target_type> gradient_sptr(target_sptr->get_empty_copy());
+  objective_function.compute_sub_gradient_without_penalty(*gradient_sptr, *target_sptr, 1);
+
+  objective_function.set_proj_data_sptr(proj_data_by_subset_sptr);
+  objective_function.set_additive_proj_data_sptr(add_proj_data_by_subset_sptr);
+  if (check(objective_function.set_up(target_sptr) == Succeeded::yes, "set-up of objective function with data by subset"))
+    {
+      shared_ptr<target_type> gradient_by_subset_sptr(target_sptr->get_empty_copy());
+      objective_function.compute_sub_gradient_without_penalty(*gradient_by_subset_sptr, *target_sptr, 1);
+      check_if_equal(*gradient_sptr, *gradient_by_subset_sptr, "gradient with ProjDataInMemoryBySubset");
+    }
+  objective_function.set_proj_data_sptr(proj_data_sptr);
+  objective_function.set_additive_proj_data_sptr(add_proj_data_sptr);
+  check(objective_function.set_up(target_sptr) == Succeeded::yes, "set-up of objective function after data by subset");
+}
+
 void
 PoissonLogLikelihoodWithLinearModelForMeanAndProjDataTests::construct_input_data(shared_ptr<target_type>& density_sptr,
                                                                                  const bool TOF_or_not)
@@ -346,6 +469,10 @@ PoissonLogLikelihoodWithLinearModelForMeanAndProjDataTests::run_tests()
     shared_ptr<target_type> density_sptr;
     construct_input_data(density_sptr, /*TOF_or_not=*/false);
     this->run_tests_for_objective_function(*this->objective_function_sptr, *density_sptr);
+    std::cerr << "   fused forward and back projection\n";
+    this->test_gradient_using_proj_matrix(density_sptr);
+    std::cerr << "   projection data stored by subset\n";
+    this->test_proj_data_by_subset(density_sptr);
     std::cerr << "   with prior\n";
     auto qp_sptr = std::make_shared<QuadraticPrior<float>>(true, 10000.F); // TODO find elemT from target_type
     check(qp_sptr->set_up(density_sptr) == Succeeded::yes, "prior set_up");
@@ -357,6 +484,8 @@ PoissonLogLikelihoodWithLinearModelForMeanAndProjDataTests::run_tests()
       shared_ptr<target_type> density_sptr;
       construct_input_data(density_sptr, /*TOF_or_not=*/true);
       this->run_tests_for_objective_function(*this->objective_function_sptr, *density_sptr);
+      std::cerr << "----- testing normalisation cache\n";
+      this->test_normalisation_cache(density_sptr);
     }
 
 #else
@@ -31,7 +31,8 @@ GatedSpatialTransformation::set_defaults()
   base_type::set_defaults();
   this->_transformation_filename_prefix = "";
   this->_spline_type = static_cast<BSpline::BSplineType>(1);
-  ;
+  this->_spatial_transformations_are_stored = false;
+  this->_precomputed_warps.clear();
 }
 
 const char* const GatedSpatialTransformation::registered_name = "Gated Spatial Transformation";
@@ -122,6 +123,7 @@ GatedSpatialTransformation::read_from_files(const std::string input_string)
   this->_spatial_transformation_y = spatial_transformation_y;
   this->_spatial_transformation_x = spatial_transformation_x;
   this->_spatial_transformations_are_stored = true;
+  this->_precomputed_warps.clear();
 }
 
 //! Implementation to write the transformation vectors
@@ -146,16 +148,8 @@ GatedSpatialTransformation::warp_image(GatedDiscretisedDensity& new_gated_image,
   assert(gated_image.get_time_gate_definitions().get_num_gates()
          == this->_spatial_transformation_x.get_time_gate_definitions().get_num_gates());
   new_gated_image.fill_with_zero();
-  if (this->_spatial_transformations_are_stored)
-    for (unsigned int gate_num = 1; gate_num <= gated_image.get_time_gate_definitions().get_num_gates(); ++gate_num)
-      new_gated_image[gate_num] = stir::warp_image((gated_image.get_densities())[gate_num - 1],
-                                                   (this->_spatial_transformation_x.get_densities())[gate_num - 1],
-                                                   (this->_spatial_transformation_y.get_densities())[gate_num - 1],
-                                                   (this->_spatial_transformation_z.get_densities())[gate_num - 1],
-                                                   BSpline::linear,
-                                                   false);
-  else
-    error("The transformation fields haven't been set properly yet.\n");
+  for (unsigned int gate_num = 1; gate_num <= gated_image.get_time_gate_definitions().get_num_gates(); ++gate_num)
+    this->warp_image(new_gated_image[gate_num], gated_image[gate_num], gate_num);
 }
 
 void
@@ -170,12 +164,9 @@ void
 GatedSpatialTransformation::accumulate_warp_image(DiscretisedDensity<3, float>& new_reference_image,
                                                   const GatedDiscretisedDensity& gated_image) const
 {
-  GatedDiscretisedDensity new_gated_image(gated_image);
-  new_gated_image.fill_with_zero();
-  this->warp_image(new_gated_image, gated_image);
   //! todo This is not implemented as sum (or should it be the average?)
   for (unsigned int gate_num = 1; gate_num <= gated_image.get_time_gate_definitions().get_num_gates(); ++gate_num)
-    new_reference_image += new_gated_image[gate_num];
+    this->accumulate_warp_image(new_reference_image, gated_image[gate_num], gate_num);
   //	new_reference_image /= gated_image.get_time_gate_definitions().get_num_gates();
 }
 
@@ -194,24 +185,50 @@ GatedSpatialTransformation::warp_image(GatedDiscretisedDensity& gated_image,
                   (this->_spatial_transformation_y.get_densities())[0]->size_all()));
       error("GatedSpatialTransformation::warp_image needs the same sizes for motion vectors and input/output images.\n");
     }
-  const shared_ptr<DiscretisedDensity<3, float>> reference_image_sptr(reference_image.clone());
   gated_image.resize_densities(this->_gate_defs);
 
-  if (this->_spatial_transformations_are_stored)
-    for (unsigned int gate_num = 1; gate_num <= gated_image.get_time_gate_definitions().get_num_gates(); ++gate_num)
-      {
-        const VoxelsOnCartesianGrid<float> density
-            = stir::warp_image(reference_image_sptr,
+  for (unsigned int gate_num = 1; gate_num <= gated_image.get_time_gate_definitions().get_num_gates(); ++gate_num)
+    {
+      const shared_ptr<DiscretisedDensity<3, float>> density_sptr(reference_image.get_empty_copy());
+      this->warp_image(*density_sptr, reference_image, gate_num);
+      gated_image.set_density_sptr(density_sptr, gate_num);
+    }
+}
+
+void
+GatedSpatialTransformation::warp_image(DiscretisedDensity<3, float>& new_image,
+                                       const DiscretisedDensity<3, float>& image,
+                                       const unsigned int gate_num) const
+{
+  if (!this->_spatial_transformations_are_stored)
+    error("The transformation fields haven't been set properly yet.");
+  if (this->warps_are_precomputed())
+    {
+      this->_precomputed_warps[gate_num - 1].warp(new_image, image);
+      return;
+    }
+  const shared_ptr<DiscretisedDensity<3, float>> image_sptr(image.clone());
+  new_image = stir::warp_image(image_sptr,
                                (this->_spatial_transformation_x.get_densities())[gate_num - 1],
                                (this->_spatial_transformation_y.get_densities())[gate_num - 1],
                                (this->_spatial_transformation_z.get_densities())[gate_num - 1],
                                BSpline::linear,
                                false);
-        const shared_ptr<DiscretisedDensity<3, float>> density_sptr(density.clone());
-        gated_image.set_density_sptr(density_sptr, gate_num);
-      }
-  else
-    error("The transformation fields haven't been set properly yet.");
+}
+
+void
+GatedSpatialTransformation::accumulate_warp_image(DiscretisedDensity<3, float>& new_image,
+                                                  const DiscretisedDensity<3, float>& image,
+                                                  const unsigned int gate_num) const
+{
+  if (this->warps_are_precomputed())
+    {
+      this->_precomputed_warps[gate_num - 1].accumulate_warp(new_image, image);
+      return;
+    }
+  const shared_ptr<DiscretisedDensity<3, float>> warped_image_sptr(new_image.get_empty_copy());
+  this->warp_image(*warped_image_sptr, image, gate_num);
+  new_image += *warped_image_sptr;
 }
 
 void
@@ -223,6 +240,21 @@ GatedSpatialTransformation::set_spatial_transformations(const GatedDiscretisedDe
   this->_spatial_transformation_y = transformation_y;
   this->_spatial_transformation_x = transformation_x;
   this->_spatial_transformations_are_stored = true;
+  this->_precomputed_warps.clear();
+}
+
+void
+GatedSpatialTransformation::precompute_warps()
+{
+  if (!this->_spatial_transformations_are_stored)
+    error("The transformation fields haven't been set properly yet.");
+  const unsigned int num_gates = this->_spatial_transformation_x.get_time_gate_definitions().get_num_gates();
+  std::vector<PrecomputedLinearWarp> precomputed_warps(num_gates);
+  for (unsigned int gate_num = 1; gate_num <= num_gates; ++gate_num)
+    precomputed_warps[gate_num - 1].set_up(this->_spatial_transformation_x[gate_num],
+                                           this->_spatial_transformation_y[gate_num],
+                                           this->_spatial_transformation_z[gate_num]);
+  this->_precomputed_warps.swap(precomputed_warps);
 }
 
 void
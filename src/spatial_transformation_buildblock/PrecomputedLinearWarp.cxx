@@ -0,0 +1,174 @@
+//
+/*
+ Copyright (C) 2026, University College London
+ This file is part of STIR.
+
+ SPDX-License-Identifier: Apache-2.0
+
+ See STIR/LICENSE.txt for details
+ */
+/*!
+ \file
+ \ingroup spatial_transformation
+ \brief Implementation of class stir::PrecomputedLinearWarp
+*/
+
+#include "stir/spatial_transformation/PrecomputedLinearWarp.h"
+#include "stir/DiscretisedDensityOnCartesianGrid.h"
+#include "stir/error.h"
+#include <algorithm>
+#include <cmath>
+
+START_NAMESPACE_STIR
+
+PrecomputedLinearWarp::PrecomputedLinearWarp()
+{}
+
+void
+PrecomputedLinearWarp::check_range(const DiscretisedDensity<3, float>& density) const
+{
+  BasicCoordinate<3, int> min_indices, max_indices;
+  if (!density.get_regular_range(min_indices, max_indices))
+    error("PrecomputedLinearWarp: image is not in regular grid");
+  if (min_indices != this->_min_indices || max_indices != this->_max_indices)
+    error("PrecomputedLinearWarp: image has different index range than the motion fields");
+}
+
+void
+PrecomputedLinearWarp::set_up(const DiscretisedDensity<3, float>& motion_x,
+                              const DiscretisedDensity<3, float>& motion_y,
+                              const DiscretisedDensity<3, float>& motion_z)
+{
+  const DiscretisedDensityOnCartesianGrid<3, float>* motion_cartesian_ptr
+      = dynamic_cast<const DiscretisedDensityOnCartesianGrid<3, float>*>(&motion_x);
+  if (motion_cartesian_ptr == 0)
+    error("PrecomputedLinearWarp: motion fields need to be on a Cartesian grid");
+  const BasicCoordinate<3, float> grid_spacing = motion_cartesian_ptr->get_grid_spacing();
+
+  if (!motion_x.get_regular_range(this->_min_indices, this->_max_indices))
+    error("PrecomputedLinearWarp: motion field is not in regular grid");
+  this->check_range(motion_y);
+  this->check_range(motion_z);
+
+  const BasicCoordinate<3, int> sizes = this->_max_indices - this->_min_indices + 1;
+  const long plane_size = static_cast<long>(sizes[2]) * sizes[3];
+  const long num_voxels = plane_size * sizes[1];
+  this->_corner_indices.resize(num_voxels);
+  this->_fractions_z.resize(num_voxels);
+  this->_fractions_y.resize(num_voxels);
+  this->_fractions_x.resize(num_voxels);
+
+  const BasicCoordinate<3, int> min = this->_min_indices;
+  const BasicCoordinate<3, int> max = this->_max_indices;
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(static)
+#endif
+  for (int z = min[1]; z <= max[1]; ++z)
+    {
+      long voxel_num = (z - min[1]) * plane_size;
+      for (int y = min[2]; y <= max[2]; ++y)
+        for (int x = min[3]; x <= max[3]; ++x, ++voxel_num)
+          {
+            // same computation as in warp_image()
+            const double d_z = static_cast<double>(z) + static_cast<double>(motion_z[z][y][x] / grid_spacing[1]);
+            const double d_y = static_cast<double>(y) + static_cast<double>(motion_y[z][y][x] / grid_spacing[2]);
+            const double d_x = static_cast<double>(x) + static_cast<double>(motion_x[z][y][x] / grid_spacing[3]);
+            if ((d_z <= min[1]) || (d_z >= max[1]) || (d_y <= min[2]) || (d_y >= max[2]) || (d_x <= min[3]) || (d_x >= max[3]))
+              {
+                this->_corner_indices[voxel_num] = -1;
+                this->_fractions_z[voxel_num] = this->_fractions_y[voxel_num] = this->_fractions_x[voxel_num] = 0.F;
+                continue;
+              }
+            const int corner_z = static_cast<int>(std::floor(d_z));
+            const int corner_y = static_cast<int>(std::floor(d_y));
+            const int corner_x = static_cast<int>(std::floor(d_x));
+            this->_corner_indices[voxel_num]
+                = (corner_z - min[1]) * plane_size + static_cast<long>(corner_y - min[2]) * sizes[3] + (corner_x - min[3]);
+            this->_fractions_z[voxel_num] = static_cast<float>(d_z - corner_z);
+            this->_fractions_y[voxel_num] = static_cast<float>(d_y - corner_y);
+            this->_fractions_x[voxel_num] = static_cast<float>(d_x - corner_x);
+          }
+    }
+}
+
+template <bool accumulate>
+void
+PrecomputedLinearWarp::actual_warp(DiscretisedDensity<3, float>& out_density,
+                                   const DiscretisedDensity<3, float>& in_density) const
+{
+  if (!this->is_set_up())
+    error("PrecomputedLinearWarp: set_up() has not been called");
+  this->check_range(in_density);
+  this->check_range(out_density);
+
+  if (&out_density == &in_density)
+    error("PrecomputedLinearWarp: input and output image have to be different objects");
+
+  // get contiguous input data for random access
+  // (we avoid get_const_full_data_ptr() here, as it is not thread-safe when several threads warp the same image)
+  std::vector<float> in_copy;
+  const float* in_data_ptr;
+  if (in_density.is_contiguous())
+    in_data_ptr = &(*in_density.begin_all_const());
+  else
+    {
+      in_copy.resize(in_density.size_all());
+      std::copy(in_density.begin_all_const(), in_density.end_all_const(), in_copy.begin());
+      in_data_ptr = in_copy.data();
+    }
+
+  const BasicCoordinate<3, int> min = this->_min_indices;
+  const BasicCoordinate<3, int> max = this->_max_indices;
+  const BasicCoordinate<3, int> sizes = max - min + 1;
+  const long row_size = sizes[3];
+  const long plane_size = static_cast<long>(sizes[2]) * row_size;
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(static)
+#endif
+  for (int z = min[1]; z <= max[1]; ++z)
+    {
+      long voxel_num = (z - min[1]) * plane_size;
+      for (int y = min[2]; y <= max[2]; ++y)
+        {
+          Array<1, float>& out_row = out_density[z][y];
+          for (int x = min[3]; x <= max[3]; ++x, ++voxel_num)
+            {
+              const long corner = this->_corner_indices[voxel_num];
+              float value = 0.F;
+              if (corner >= 0)
+                {
+                  const float f_z = this->_fractions_z[voxel_num];
+                  const float f_y = this->_fractions_y[voxel_num];
+                  const float f_x = this->_fractions_x[voxel_num];
+                  const float* const p = in_data_ptr + corner;
+                  const float v00 = p[0] + f_x * (p[1] - p[0]);
+                  const float v01 = p[row_size] + f_x * (p[row_size + 1] - p[row_size]);
+                  const float v10 = p[plane_size] + f_x * (p[plane_size + 1] - p[plane_size]);
+                  const float v11 = p[plane_size + row_size] + f_x * (p[plane_size + row_size + 1] - p[plane_size + row_size]);
+                  const float v0 = v00 + f_y * (v01 - v00);
+                  const float v1 = v10 + f_y * (v11 - v10);
+                  value = v0 + f_z * (v1 - v0);
+                }
+              if (accumulate)
+                out_row[x] += value;
+              else
+                out_row[x] = value;
+            }
+        }
+    }
+}
+
+void
+PrecomputedLinearWarp::warp(DiscretisedDensity<3, float>& out_density, const DiscretisedDensity<3, float>& in_density) const
+{
+  this->actual_warp<false>(out_density, in_density);
+}
+
+void
+PrecomputedLinearWarp::accumulate_warp(DiscretisedDensity<3, float>& out_density,
+                                       const DiscretisedDensity<3, float>& in_density) const
+{
+  this->actual_warp<true>(out_density, in_density);
+}
+
+END_NAMESPACE_STIR
@@ -23,6 +23,11 @@
 #include "stir/modelling/PlasmaData.h"
 #include "stir/modelling/ParametricDiscretisedDensity.h"
 #include "stir/TimeFrameDefinitions.h"
+#include "stir/DynamicDiscretisedDensity.h"
+#include "stir/VoxelsOnCartesianGrid.h"
+#include "stir/IndexRange2D.h"
+#include "stir/IndexRange3D.h"
+#include "stir/Scanner.h"
 #include "stir/utilities.h"
 #include <boost/shared_array.hpp>
 
@@ -139,6 +144,43 @@ modellingTests::run_tests()
               file_model_array[param_num][frame_num], correct_model_array[param_num][frame_num], "Check ModelMatrix reading. ");
         }
   }
+  {
+    std::cerr << "\nTesting the frame-by-frame multiplication with the ModelMatrix ..." << std::endl;
+    const int num_frames = 3;
+    Array<2, float> model_array(IndexRange2D(1, 2, 1, num_frames));
+    for (int frame_num = 1; frame_num <= num_frames; ++frame_num)
+      {
+        model_array[1][frame_num] = 1.F + frame_num;
+        model_array[2][frame_num] = 0.5F * frame_num * frame_num;
+      }
+    ModelMatrix<2> model_matrix;
+    model_matrix.set_model_array(model_array);
+
+    std::vector<std::pair<double, double>> frame_times;
+    for (int frame_num = 1; frame_num <= num_frames; ++frame_num)
+      frame_times.push_back(std::make_pair(frame_num * 10., frame_num * 10. + 10.));
+    const shared_ptr<VoxelsOnCartesianGrid<float>> frame_sptr(new VoxelsOnCartesianGrid<float>(
+        IndexRange3D(0, 2, -2, 2, -3, 3), CartesianCoordinate3D<float>(0.F, 0.F, 0.F), CartesianCoordinate3D<float>(1.F, 1.F, 1.F)));
+    DynamicDiscretisedDensity dyn_image(
+        TimeFrameDefinitions(frame_times), 0., shared_ptr<Scanner>(new Scanner(Scanner::E962)), frame_sptr);
+    for (int frame_num = 1; frame_num <= num_frames; ++frame_num)
+      {
+        float value = 1.F;
+        for (auto iter = dyn_image[frame_num].begin_all(); iter != dyn_image[frame_num].end_all(); ++iter, value += 1.F)
+          *iter = value * frame_num;
+      }
+
+    ParametricVoxelsOnCartesianGrid all_frames_result(*frame_sptr);
+    model_matrix.multiply_dynamic_image_with_model(all_frames_result, dyn_image);
+    ParametricVoxelsOnCartesianGrid frame_by_frame_result(*frame_sptr);
+    std::fill(frame_by_frame_result.begin_all(), frame_by_frame_result.end_all(), 0.F);
+    for (int frame_num = 1; frame_num <= num_frames; ++frame_num)
+      model_matrix.multiply_frame_image_with_model_and_add_to_input(frame_by_frame_result, dyn_image[frame_num], frame_num);
+
+    auto iter = frame_by_frame_result.begin_all_const();
+    for (auto ref_iter = all_frames_result.begin_all_const(); ref_iter != all_frames_result.end_all_const(); ++ref_iter, ++iter)
+      check_if_equal(*ref_iter, *iter, "Check frame-by-frame multiplication with ModelMatrix");
+  }
   {
     // This tests uses the results from the Mathematica. The used plasma and frame files are parts of the t00196 scan.
     std::cerr << "\nTesting the sampling of PlasmaData into frames ..." << std::endl;
@@ -46,6 +46,8 @@
 #include "stir/ArrayFunction.h"
 #include "stir/array_index_functions.h"
 #include "stir/copy_fill.h"
+#include "stir/ArrayStoragePool.h"
+#include "stir/num_threads.h"
 #include <functional>
 #include <algorithm>
 
@@ -1074,6 +1076,55 @@ ArrayTests::run_tests()
     check_if_equal(arr1, arr3, "make_array inline vs function with assignment");
     check_if_equal(arr1, arr4, "make_array inline constructor from function");
   }
+  {
+    cerr << "Testing ArrayStoragePool" << endl;
+
+    ArrayStoragePool<float> pool(1);
+    const IndexRange<2> range(Coordinate2D<int>(-1, 2), Coordinate2D<int>(3, 6));
+    float* first_data_ptr;
+    {
+      Array<2, float> arr(range, pool.get_block(range.size_all()));
+      arr.fill(2.F);
+      check_if_equal(arr[3][6], 2.F, "ArrayStoragePool: array element");
+      first_data_ptr = arr.get_full_data_ptr();
+      arr.release_full_data_ptr();
+      check_if_equal(pool.get_num_free_blocks(), std::size_t(0), "ArrayStoragePool: no free blocks while in use");
+    }
+    check_if_equal(pool.get_num_free_blocks(), std::size_t(1), "ArrayStoragePool: block returned to pool");
+    {
+      Array<2, float> arr1(range, pool.get_block(range.size_all()));
+      Array<2, float> arr2(range, pool.get_block(range.size_all()));
+      check_if_equal(pool.get_num_free_blocks(), std::size_t(0), "ArrayStoragePool: block taken from pool");
+      check(arr1.get_full_data_ptr() == first_data_ptr, "ArrayStoragePool: block reused");
+      arr1.release_full_data_ptr();
+    }
+    // pool was constructed to keep at most 1 block
+    check_if_equal(pool.get_num_free_blocks(), std::size_t(1), "ArrayStoragePool: maximum number of free blocks");
+    pool.clear();
+    check_if_equal(pool.get_num_free_blocks(), std::size_t(0), "ArrayStoragePool: clear");
+  }
+  {
+    cerr << "Testing parallel first-touch initialisation" << endl;
+
+    // large enough to use more than 1 thread
+    const IndexRange<3> range(Coordinate3D<int>(-2, 1, 3), Coordinate3D<int>(60, 130, 160));
+    for (const bool parallel : { true, false })
+      {
+        set_parallel_first_touch(parallel);
+        check_if_equal(get_parallel_first_touch(), parallel, "set_parallel_first_touch");
+        Array<3, float> arr(range);
+        check(std::all_of(arr.begin_all_const(), arr.end_all_const(), [](const float v) { return v == 0.F; }),
+              "Array constructor should set all elements to 0");
+        Array<1, double> arr1d(-3, 500000);
+        check(std::all_of(arr1d.begin(), arr1d.end(), [](const double v) { return v == 0.; }),
+              "Array<1> constructor should set all elements to 0");
+        fill_with_first_touch(arr.get_full_data_ptr(), arr.size_all(), 3.F);
+        arr.release_full_data_ptr();
+        check(std::all_of(arr.begin_all_const(), arr.end_all_const(), [](const float v) { return v == 3.F; }),
+              "fill_with_first_touch");
+      }
+    set_parallel_first_touch(true);
+  }
   std::cerr << "timings\n";
   {
     HighResWallClockTimer t;
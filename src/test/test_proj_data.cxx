@@ -11,7 +11,7 @@
 
 */
 /*
-    Copyright (C) 2015, 2020, 2022, 2024 University College London
+    Copyright (C) 2015, 2020, 2022, 2024, 2026 University College London
     Copyright (C) 2020, National Physical Laboratory
     This file is part of STIR.
 
@@ -22,6 +22,7 @@
 
 #include "stir/ProjDataInMemory.h"
 #include "stir/ProjDataInterfile.h"
+#include "stir/ProjDataFromChunkedFile.h"
 #include "stir/ExamInfo.h"
 #include "stir/ProjDataInfo.h"
 #include "stir/ProjDataInfoCylindricalArcCorr.h"
@@ -51,6 +52,7 @@ public:
 private:
   void run_tests_on_proj_data(ProjData&);
   void run_tests_in_memory_only(ProjDataInMemory&);
+  void run_tests_chunked_file(const ProjData&);
 };
 
 void
@@ -403,6 +405,37 @@ ProjDataTests::run_tests_in_memory_only(ProjDataInMemory& proj_data)
   }
 }
 
+void
+ProjDataTests::run_tests_chunked_file(const ProjData& proj_data)
+{
+  std::cerr << "\ntest ProjDataFromChunkedFile\n";
+  const ProjDataInMemory org_proj_data(proj_data);
+  const auto org_norm = norm(org_proj_data.begin(), org_proj_data.end());
+  for (int quantise = 0; quantise <= 1; ++quantise)
+    {
+      check(ProjDataFromChunkedFile::write_to_file("test_proj_data_chunked.hs", proj_data, 1, quantise != 0) == Succeeded::yes,
+            "ProjDataFromChunkedFile::write_to_file");
+      shared_ptr<ProjData> read_proj_data_sptr = ProjData::read_from_file("test_proj_data_chunked.hs");
+      check(!is_null_ptr(dynamic_pointer_cast<ProjDataFromChunkedFile>(read_proj_data_sptr)),
+            "read_from_file should return ProjDataFromChunkedFile");
+      const float tolerance = quantise ? 0.001F : 0.00001F;
+      // compare all data (read by segment)
+      ProjDataInMemory diff(*read_proj_data_sptr);
+      diff.sapyb(1.F, org_proj_data, -1.F);
+      check(norm(diff.begin(), diff.end()) <= tolerance * org_norm, "ProjDataFromChunkedFile: comparing all data");
+      // compare a viewgram and a sinogram (read via a single chunk, and via many chunks)
+      const int timing_pos_num = proj_data.get_max_tof_pos_num();
+      const int segment_num = proj_data.get_max_segment_num();
+      set_tolerance(tolerance);
+      check_if_equal(org_proj_data.get_viewgram(1, segment_num, false, timing_pos_num),
+                     read_proj_data_sptr->get_viewgram(1, segment_num, false, timing_pos_num),
+                     "ProjDataFromChunkedFile: comparing viewgram");
+      check_if_equal(org_proj_data.get_sinogram(0, segment_num, false, timing_pos_num),
+                     read_proj_data_sptr->get_sinogram(0, segment_num, false, timing_pos_num),
+                     "ProjDataFromChunkedFile: comparing sinogram");
+    }
+}
+
 void
 ProjDataTests::run_tests()
 {
@@ -439,6 +472,8 @@ ProjDataTests::run_tests()
 
     ProjDataInterfile(exam_info_sptr, proj_data_info_sptr, "test_proj_data.hs", std::ios::in | std::ios::out | std::ios::trunc);
     run_tests_on_proj_data(proj_data_in_memory);
+
+    run_tests_chunked_file(proj_data_in_memory);
   }
 
   std::cerr << "\n--------------------------------TOF tests\n";
@@ -471,6 +506,8 @@ ProjDataTests::run_tests()
     ProjDataInterfile proj_data_interfile(
         exam_info_sptr, proj_data_info_sptr, "test_proj_data.hs", std::ios::in | std::ios::out | std::ios::trunc);
     run_tests_on_proj_data(proj_data_interfile);
+
+    run_tests_chunked_file(proj_data_interfile);
   }
 }
 END_NAMESPACE_STIR
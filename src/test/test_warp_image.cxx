@@ -24,6 +24,7 @@
 #include "stir/spatial_transformation/warp_image.h"
 #include "stir/RunTests.h"
 #include "stir/spatial_transformation/GatedSpatialTransformation.h"
+#include "stir/spatial_transformation/PrecomputedLinearWarp.h"
 #include <iostream>
 #include <algorithm>
 
@@ -174,6 +175,49 @@ warp_imageTests::run_tests()
     check_if_equal(
         accumulated_image[new_indices], 0.F, "testing the accumulated image at the location where the non-zero point had moved");
   }
+  std::cerr << "Tests for class PrecomputedLinearWarp" << std::endl;
+  {
+    // non-integer motion and a non-trivial image
+    VoxelsOnCartesianGrid<float> smooth_image(range, origin, grid_spacing);
+    for (int z = range.get_min_index(); z <= range.get_max_index(); ++z)
+      for (int y = range[z].get_min_index(); y <= range[z].get_max_index(); ++y)
+        for (int x = range[z][y].get_min_index(); x <= range[z][y].get_max_index(); ++x)
+          smooth_image[z][y][x] = 1.F + z + 0.5F * y * y - 0.1F * x * y;
+    const shared_ptr<VoxelsOnCartesianGrid<float>> smooth_image_sptr(smooth_image.clone());
+    VoxelsOnCartesianGrid<float> frac_motion_x(range, origin, grid_spacing);
+    VoxelsOnCartesianGrid<float> frac_motion_y(range, origin, grid_spacing);
+    VoxelsOnCartesianGrid<float> frac_motion_z(range, origin, grid_spacing);
+    for (int z = range.get_min_index(); z <= range.get_max_index(); ++z)
+      {
+        frac_motion_x[z].fill(-1.3F * grid_spacing[3]);
+        frac_motion_y[z].fill((0.2F + 0.05F * z) * grid_spacing[2]);
+        frac_motion_z[z].fill(0.7F * grid_spacing[1]);
+      }
+    const shared_ptr<VoxelsOnCartesianGrid<float>> frac_motion_x_sptr(frac_motion_x.clone());
+    const shared_ptr<VoxelsOnCartesianGrid<float>> frac_motion_y_sptr(frac_motion_y.clone());
+    const shared_ptr<VoxelsOnCartesianGrid<float>> frac_motion_z_sptr(frac_motion_z.clone());
+
+    const VoxelsOnCartesianGrid<float> warped_image = warp_image(
+        smooth_image_sptr, frac_motion_x_sptr, frac_motion_y_sptr, frac_motion_z_sptr, BSpline::BSplineType(1), 0);
+    PrecomputedLinearWarp precomputed_warp;
+    precomputed_warp.set_up(frac_motion_x, frac_motion_y, frac_motion_z);
+    VoxelsOnCartesianGrid<float> precomputed_warped_image(range, origin, grid_spacing);
+    precomputed_warp.warp(precomputed_warped_image, smooth_image);
+    set_tolerance(.001);
+    check_if_equal(precomputed_warped_image, warped_image, "testing PrecomputedLinearWarp::warp against warp_image");
+    precomputed_warp.accumulate_warp(precomputed_warped_image, smooth_image);
+    precomputed_warped_image /= 2;
+    check_if_equal(precomputed_warped_image, warped_image, "testing PrecomputedLinearWarp::accumulate_warp against warp_image");
+
+    // GatedSpatialTransformation should give the same result with precomputed warps
+    mvtest.precompute_warps();
+    check(mvtest.warps_are_precomputed(), "testing GatedSpatialTransformation::precompute_warps");
+    VoxelsOnCartesianGrid<float> accumulated_image_with_precomputed_warps(range, origin, grid_spacing);
+    mvtest.warp_image(accumulated_image_with_precomputed_warps, gated_image);
+    check_if_equal(accumulated_image_with_precomputed_warps,
+                   accumulated_image,
+                   "testing GatedSpatialTransformation::warp_image with precomputed warps");
+  }
 }
 END_NAMESPACE_STIR
 
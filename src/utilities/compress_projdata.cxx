@@ -0,0 +1,44 @@
+/*
+ Copyright (C) 2026, University College London
+ This file is part of STIR.
+
+ SPDX-License-Identifier: Apache-2.0
+
+ See STIR/LICENSE.txt for details
+ */
+/*!
+ \file
+ \ingroup utilities
+
+ \brief Writes projection data as an Interfile header with a compressed data file
+
+ \see stir::ProjDataFromChunkedFile. The output can be read by all STIR programs. Use
+ for instance <tt>stir_math -s</tt> to convert it back to an uncompressed file.
+ */
+#include "stir/ProjDataFromChunkedFile.h"
+#include "stir/Succeeded.h"
+#include <iostream>
+#include <cstdlib>
+
+USING_NAMESPACE_STIR
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 3 || argc > 5)
+    {
+      std::cerr << "Usage: " << argv[0] << " output_filename input_filename [compression_level [quantise_to_16_bits]]\n"
+                << "compression_level is between 0 and 9 (defaults to 1)\n"
+                << "quantise_to_16_bits is 0 or 1 (defaults to 0). If 1, the data are not stored exactly.\n";
+      exit(EXIT_FAILURE);
+    }
+  const std::string output_filename = argv[1];
+  const shared_ptr<ProjData> proj_data_sptr = ProjData::read_from_file(argv[2]);
+  const int compression_level = argc > 3 ? atoi(argv[3]) : 1;
+  const bool quantise_to_16_bits = argc > 4 ? atoi(argv[4]) != 0 : false;
+
+  const Succeeded res
+      = ProjDataFromChunkedFile::write_to_file(output_filename, *proj_data_sptr, compression_level, quantise_to_16_bits);
+
+  return res == Succeeded::yes ? EXIT_SUCCESS : EXIT_FAILURE;
+}